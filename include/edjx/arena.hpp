@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace edjx {
+
+/**
+ * @brief Per-invocation arena allocation.
+ *
+ * An edjx::memory::Arena hands out memory by bumping a pointer inside
+ * large blocks, and frees everything at once when it is reset. Containers
+ * that use edjx::memory::ArenaAllocator (e.g., edjx::memory::ArenaString
+ * and edjx::memory::ArenaVector) never return memory one object at
+ * a time, which avoids allocator overhead and fragmentation of the linear
+ * memory during a request.
+ *
+ * ```
+ * edjx::memory::Arena arena;
+ * {
+ *     edjx::memory::ArenaVector<edjx::memory::ArenaString> names(arena);
+ *     names.emplace_back("index.html", arena);
+ *     // ...
+ * } // names is destroyed while its memory is still valid
+ * arena.reset(); // everything allocated above is gone
+ * ```
+ *
+ * Containers that use the arena must be destroyed before the arena is
+ * reset, since their destructors still touch the memory they point to.
+ */
+namespace memory {
+
+    /**
+     * @brief A bump allocator that releases all of its memory at once.
+     *
+     * One block of the default size is kept across reset() calls, so
+     * a warm instance that reuses the arena for every request does not
+     * touch the global heap in the common case. Larger blocks made for
+     * oversized allocations are always returned to the heap.
+     */
+    class Arena {
+    public:
+        /// Default size of the arena blocks in bytes
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        /**
+         * @brief Constructs an empty arena. No memory is allocated until
+         * the first allocation.
+         *
+         * @param block_size Size of the blocks requested from the global heap
+         */
+        inline explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE)
+            : block_size(block_size),
+            head(nullptr),
+            cursor(nullptr),
+            limit(nullptr),
+            allocations(0),
+            used(0),
+            peak(0) {}
+
+        Arena(const Arena &) = delete;
+        Arena & operator=(const Arena &) = delete;
+
+        inline ~Arena() {
+            free_blocks(nullptr);
+        }
+
+        /**
+         * @brief Allocates memory from the arena.
+         *
+         * @param size Number of bytes
+         * @param alignment Alignment of the returned address (a power of two)
+         * @return Pointer to the allocated memory
+         */
+        inline void * allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+            uintptr_t address = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+            if (cursor == nullptr || address + size > reinterpret_cast<uintptr_t>(limit)) {
+                add_block(size + alignment);
+                address = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+            }
+            cursor = reinterpret_cast<uint8_t *>(address + size);
+            allocations++;
+            used += size;
+            if (used > peak) {
+                peak = used;
+            }
+            return reinterpret_cast<void *>(address);
+        }
+
+        /**
+         * @brief Releases all memory allocated from the arena.
+         *
+         * One block of the default size is kept for reuse and all other
+         * blocks are returned to the global heap. Objects allocated from
+         * the arena must not be used afterwards; their destructors are
+         * not run.
+         */
+        inline void reset() {
+            Block * kept = nullptr;
+            while (head != nullptr) {
+                Block * next = head->next;
+                if (kept == nullptr && head->size == block_size) {
+                    kept = head;
+                    kept->next = nullptr;
+                } else {
+                    std::free(head);
+                }
+                head = next;
+            }
+            head = kept;
+            cursor = kept != nullptr ? kept->data() : nullptr;
+            limit = kept != nullptr ? cursor + kept->size : nullptr;
+            allocations = 0;
+            used = 0;
+        }
+
+        /**
+         * @brief Returns the number of allocations since the last reset.
+         *
+         * @return Number of allocations
+         */
+        inline size_t allocation_count() const {
+            return allocations;
+        }
+
+        /**
+         * @brief Returns the number of bytes allocated since the last reset.
+         *
+         * @return Number of bytes
+         */
+        inline size_t bytes_used() const {
+            return used;
+        }
+
+        /**
+         * @brief Returns the highest value of bytes_used() since the arena
+         * was constructed.
+         *
+         * @return Number of bytes
+         */
+        inline size_t peak_bytes_used() const {
+            return peak;
+        }
+
+    private:
+        struct Block {
+            Block * next;
+            size_t size;
+
+            inline uint8_t * data() {
+                return reinterpret_cast<uint8_t *>(this + 1);
+            }
+        };
+
+        inline void add_block(size_t min_size) {
+            size_t size = min_size > block_size ? min_size : block_size;
+            void * memory = std::malloc(sizeof(Block) + size);
+            if (memory == nullptr) {
+                std::abort();
+            }
+            Block * block = static_cast<Block *>(memory);
+            block->next = head;
+            block->size = size;
+            head = block;
+            cursor = block->data();
+            limit = cursor + size;
+        }
+
+        inline void free_blocks(Block * keep) {
+            while (head != nullptr && head != keep) {
+                Block * next = head->next;
+                std::free(head);
+                head = next;
+            }
+        }
+
+        size_t block_size;
+        Block * head;
+        uint8_t * cursor;
+        uint8_t * limit;
+        size_t allocations;
+        size_t used;
+        size_t peak;
+    };
+
+    /**
+     * @brief Standard allocator that takes memory from an Arena.
+     *
+     * Deallocation is a no-op; memory is reclaimed by Arena::reset().
+     */
+    template <typename T>
+    class ArenaAllocator {
+    public:
+        /// Allocated type
+        typedef T value_type;
+
+        /**
+         * @brief Constructs an allocator for the given arena.
+         *
+         * @param arena Arena that provides the memory
+         */
+        inline ArenaAllocator(Arena & arena) noexcept : arena(&arena) {}
+
+        template <typename U>
+        inline ArenaAllocator(const ArenaAllocator<U> & other) noexcept : arena(other.get_arena()) {}
+
+        inline T * allocate(size_t n) {
+            return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        inline void deallocate(T *, size_t) noexcept {}
+
+        /**
+         * @brief Returns the arena used by this allocator.
+         *
+         * @return Arena
+         */
+        inline Arena * get_arena() const noexcept {
+            return arena;
+        }
+
+        template <typename U>
+        inline bool operator==(const ArenaAllocator<U> & other) const noexcept {
+            return arena == other.get_arena();
+        }
+
+        template <typename U>
+        inline bool operator!=(const ArenaAllocator<U> & other) const noexcept {
+            return arena != other.get_arena();
+        }
+
+    private:
+        Arena * arena;
+    };
+
+    /// String allocated from an Arena
+    typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> ArenaString;
+
+    /// Vector allocated from an Arena
+    template <typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    /**
+     * @brief Resets an arena when the scope ends (e.g., at the end of
+     * a request handler).
+     *
+     * Declare the scope before any container that uses the arena, so
+     * the containers are destroyed before the arena is reset.
+     *
+     * ```
+     * edjx::memory::ArenaScope scope(arena);
+     * edjx::memory::ArenaString path(arena);
+     * ```
+     */
+    class ArenaScope {
+    public:
+        /**
+         * @brief Constructs a scope guard for the arena.
+         *
+         * @param arena Arena to reset at the end of the scope
+         */
+        inline explicit ArenaScope(Arena & arena) : arena(arena) {}
+
+        ArenaScope(const ArenaScope &) = delete;
+        ArenaScope & operator=(const ArenaScope &) = delete;
+
+        inline ~ArenaScope() {
+            arena.reset();
+        }
+
+    private:
+        Arena & arena;
+    };
+
+}}
@@ -0,0 +1,458 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Requires C++17 and coroutine support: -std=c++20, or -std=c++17 with
+// -fcoroutines-ts (clang) or -fcoroutines (GCC).
+#if __cplusplus < 201703L
+#error "edjx/async.hpp requires C++17 or later with coroutine support"
+#elif __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define EDJX_COROUTINE_NAMESPACE std
+#elif __has_include(<experimental/coroutine>)
+#include <experimental/coroutine>
+#define EDJX_COROUTINE_NAMESPACE std::experimental
+#else
+#error "edjx/async.hpp requires coroutine support (-std=c++20, or -std=c++17 with -fcoroutines-ts or -fcoroutines)"
+#endif
+
+#include "error.hpp"
+#include "fetch.hpp"
+#include "kv.hpp"
+#include "storage.hpp"
+#include "stream.hpp"
+
+namespace edjx {
+
+/**
+ * @brief Coroutine-based API for composing pending operations.
+ *
+ * Tasks run on a single-threaded event loop driven by the function
+ * itself. When a task awaits an operation, the operation is started
+ * (if the host allows starting it without waiting, like an HTTP fetch)
+ * and the task is queued behind the other ready tasks. All tasks
+ * therefore issue their requests before any of them blocks on a result,
+ * and independent requests are in flight at the same time.
+ *
+ * ```
+ * edjx::async::Task<void> load_profile(Context & ctx) {
+ *     ctx.fetch_error = co_await edjx::fetch::send_async(ctx.fetch, ctx.fetch_response);
+ * }
+ *
+ * edjx::async::Task<void> load_config(Context & ctx) {
+ *     ctx.kv_error = co_await edjx::kv::get_async(ctx.config, "config");
+ * }
+ *
+ * edjx::async::EventLoop & loop = edjx::async::EventLoop::current();
+ * loop.spawn(load_profile(ctx));
+ * loop.spawn(load_config(ctx));
+ * loop.run();
+ * ```
+ */
+namespace async {
+
+    namespace coro = EDJX_COROUTINE_NAMESPACE;
+
+    /**
+     * @brief Single-threaded queue of coroutines that are ready to run.
+     */
+    class EventLoop {
+    public:
+        /**
+         * @brief Returns the event loop of the current invocation.
+         *
+         * @return Event loop
+         */
+        static inline EventLoop & current() {
+            static EventLoop loop;
+            return loop;
+        }
+
+        /**
+         * @brief Queues a suspended coroutine to be resumed by run().
+         *
+         * @param handle Coroutine handle
+         */
+        inline void schedule(coro::coroutine_handle<> handle) {
+            ready.push_back(handle);
+        }
+
+        /**
+         * @brief Resumes queued coroutines until none are left.
+         *
+         * Tasks passed to spawn() are destroyed when they finish.
+         */
+        inline void run() {
+            while (!ready.empty()) {
+                coro::coroutine_handle<> handle = ready.front();
+                ready.pop_front();
+                handle.resume();
+            }
+            for (coro::coroutine_handle<> handle : spawned) {
+                handle.destroy();
+            }
+            spawned.clear();
+        }
+
+        /**
+         * @brief Starts a task on this event loop.
+         *
+         * The task runs when run() is called, and the loop owns it
+         * from now on.
+         *
+         * @param task Task to run
+         */
+        template <typename Task>
+        inline void spawn(Task && task) {
+            coro::coroutine_handle<> handle = task.release();
+            spawned.push_back(handle);
+            schedule(handle);
+        }
+
+    private:
+        std::deque<coro::coroutine_handle<>> ready;
+        std::vector<coro::coroutine_handle<>> spawned;
+    };
+
+    template <typename T>
+    class Task;
+
+    namespace detail {
+
+        /// Resumes the awaiting coroutine (if any) when a task finishes.
+        struct FinalAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            template <typename Promise>
+            coro::coroutine_handle<> await_suspend(coro::coroutine_handle<Promise> handle) noexcept {
+                coro::coroutine_handle<> continuation = handle.promise().continuation;
+                if (continuation) {
+                    return continuation;
+                }
+                return coro::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        struct PromiseBase {
+            coro::coroutine_handle<> continuation;
+
+            coro::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() const noexcept {
+                return {};
+            }
+
+            void unhandled_exception() const noexcept {
+                std::abort();
+            }
+        };
+
+        template <typename T>
+        struct Promise : PromiseBase {
+            // The value is constructed only when the coroutine returns,
+            // so `T` does not need a default constructor.
+            union Storage {
+                T value;
+
+                Storage() {}
+                ~Storage() {}
+            } storage;
+            bool has_value = false;
+
+            Promise() noexcept {}
+            Promise(const Promise &) = delete;
+            Promise & operator=(const Promise &) = delete;
+
+            ~Promise() {
+                if (has_value) {
+                    storage.value.~T();
+                }
+            }
+
+            Task<T> get_return_object() noexcept;
+
+            void return_value(T v) {
+                new (&storage.value) T(std::move(v));
+                has_value = true;
+            }
+        };
+
+        template <>
+        struct Promise<void> : PromiseBase {
+            Task<void> get_return_object() noexcept;
+
+            void return_void() const noexcept {}
+        };
+
+    }
+
+    /**
+     * @brief A lazily started coroutine that produces a value of type `T`.
+     *
+     * A task starts running when it is awaited or passed to
+     * EventLoop::spawn(). Only a task returned by a coroutine can be
+     * awaited; awaiting an empty task (default-constructed, moved from,
+     * or released) aborts the function.
+     */
+    template <typename T>
+    class Task {
+    public:
+        /// Coroutine promise type
+        typedef detail::Promise<T> promise_type;
+
+        inline Task() : handle(nullptr) {}
+        inline explicit Task(coro::coroutine_handle<promise_type> handle) : handle(handle) {}
+        inline Task(Task && other) noexcept : handle(other.handle) {
+            other.handle = nullptr;
+        }
+        inline Task & operator=(Task && other) noexcept {
+            if (this != &other) {
+                if (handle) {
+                    handle.destroy();
+                }
+                handle = other.handle;
+                other.handle = nullptr;
+            }
+            return *this;
+        }
+        Task(const Task &) = delete;
+        Task & operator=(const Task &) = delete;
+        inline ~Task() {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        /**
+         * @brief Gives up ownership of the coroutine.
+         *
+         * @return Coroutine handle
+         */
+        inline coro::coroutine_handle<promise_type> release() {
+            coro::coroutine_handle<promise_type> result = handle;
+            handle = nullptr;
+            return result;
+        }
+
+        inline bool await_ready() const noexcept {
+            if (!handle) {
+                std::abort();
+            }
+            return handle.done();
+        }
+
+        inline coro::coroutine_handle<> await_suspend(coro::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        inline T await_resume() {
+            if constexpr (!std::is_void<T>::value) {
+                return std::move(handle.promise().storage.value);
+            }
+        }
+
+    private:
+        coro::coroutine_handle<promise_type> handle;
+    };
+
+    namespace detail {
+
+        template <typename T>
+        inline Task<T> Promise<T>::get_return_object() noexcept {
+            return Task<T>(coro::coroutine_handle<Promise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> Promise<void>::get_return_object() noexcept {
+            return Task<void>(coro::coroutine_handle<Promise<void>>::from_promise(*this));
+        }
+
+    }
+
+    /**
+     * @brief An operation that completes with a blocking host call.
+     *
+     * The awaiting task is queued behind the other ready tasks before
+     * the call is made, so operations that can be started without
+     * blocking get started first.
+     */
+    template <typename Complete>
+    class DeferredOperation {
+    public:
+        inline explicit DeferredOperation(Complete complete) : complete(std::move(complete)) {}
+
+        inline bool await_ready() const noexcept {
+            return false;
+        }
+
+        inline void await_suspend(coro::coroutine_handle<> handle) {
+            EventLoop::current().schedule(handle);
+        }
+
+        inline auto await_resume() {
+            return complete();
+        }
+
+    private:
+        Complete complete;
+    };
+
+    /**
+     * @brief Creates a DeferredOperation.
+     *
+     * @param complete Function that performs the blocking call and
+     * returns its result
+     * @return Awaitable operation
+     */
+    template <typename Complete>
+    inline DeferredOperation<Complete> defer(Complete complete) {
+        return DeferredOperation<Complete>(std::move(complete));
+    }
+
+    /**
+     * @brief Awaitable HTTP fetch.
+     *
+     * The request (including its body) is sent when the operation is
+     * awaited, and the response is collected after the other ready tasks
+     * had a chance to run.
+     */
+    class FetchOperation {
+    public:
+        inline FetchOperation(edjx::fetch::HttpFetch & request, edjx::fetch::FetchResponse & response)
+            : request(request),
+            response(response),
+            result(edjx::error::HttpError::Success) {}
+
+        inline bool await_ready() const noexcept {
+            return false;
+        }
+
+        inline void await_suspend(coro::coroutine_handle<> handle) {
+            edjx::stream::WriteStream write_stream;
+            result = request.send_streaming(pending, write_stream);
+            if (result == edjx::error::HttpError::Success) {
+                if (!request.body.empty()
+                        && write_stream.write_chunk(request.body) != edjx::error::StreamError::Success) {
+                    // Aborting (rather than closing) keeps the upstream
+                    // from taking a truncated body as complete.
+                    write_stream.abort();
+                    edjx::fetch::FetchResponse aborted;
+                    pending.get_fetch_response(aborted);
+                    result = edjx::error::HttpError::HTTPFetchRequestFailed;
+                } else {
+                    write_stream.close();
+                }
+            }
+            EventLoop::current().schedule(handle);
+        }
+
+        inline edjx::error::HttpError await_resume() {
+            if (result != edjx::error::HttpError::Success) {
+                return result;
+            }
+            return pending.get_fetch_response(response);
+        }
+
+    private:
+        edjx::fetch::HttpFetch & request;
+        edjx::fetch::FetchResponse & response;
+        edjx::fetch::FetchResponsePending pending;
+        edjx::error::HttpError result;
+    };
+
+}
+
+namespace fetch {
+
+    /**
+     * @brief Sends the request without waiting for the response.
+     *
+     * `co_await` on the result yields edjx::error::HttpError::Success
+     * once the response has been received and stored in `response`.
+     *
+     * @param request Request to send
+     * @param response The response will be stored here
+     * @return Awaitable operation
+     */
+    inline edjx::async::FetchOperation send_async(HttpFetch & request, FetchResponse & response) {
+        return edjx::async::FetchOperation(request, response);
+    }
+
+}
+
+namespace storage {
+
+    /**
+     * @brief Awaitable version of [`edjx::storage::get`].
+     *
+     * `co_await` on the result yields an edjx::error::StorageError.
+     *
+     * @param result Result File
+     * @param bucket_id Bucket ID
+     * @param file_name File name
+     * @return Awaitable operation
+     */
+    inline auto get_async(
+        StorageResponse & result,
+        const std::string & bucket_id,
+        const std::string & file_name
+    ) {
+        return edjx::async::defer([&result, bucket_id, file_name]() {
+            return get(result, bucket_id, file_name);
+        });
+    }
+
+}
+
+namespace kv {
+
+    /**
+     * @brief Awaitable version of [`edjx::kv::get`].
+     *
+     * `co_await` on the result yields an edjx::error::KVError.
+     *
+     * @param result Returned value associated with the key
+     * @param key Key
+     * @return Awaitable operation
+     */
+    inline auto get_async(std::vector<uint8_t> & result, const std::string & key) {
+        return edjx::async::defer([&result, key]() {
+            return get(result, key);
+        });
+    }
+
+}
+
+namespace stream {
+
+    /**
+     * @brief Awaitable version of ReadStream::read_chunk().
+     *
+     * `co_await` on the result yields an edjx::error::StreamError.
+     *
+     * @param read_stream Stream to read from
+     * @param result The received chunk of binary data
+     * @return Awaitable operation
+     */
+    inline auto read_chunk_async(ReadStream & read_stream, std::vector<uint8_t> & result) {
+        return edjx::async::defer([&read_stream, &result]() {
+            return read_stream.read_chunk(result);
+        });
+    }
+
+}}
+
+#undef EDJX_COROUTINE_NAMESPACE
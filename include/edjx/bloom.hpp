@@ -0,0 +1,463 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "error.hpp"
+#include "kv.hpp"
+#include "storage.hpp"
+
+namespace edjx {
+
+/**
+ * @brief Membership filters that answer definite misses without a host call.
+ *
+ * A Bloom filter of the keys (or file names) that exist is saved in the
+ * KV store by a single writer, e.g., the job that ingests the data:
+ *
+ * ```
+ * edjx::bloom::BloomFilter filter(key_count, 0.01);
+ * for (const std::string & key : keys) {
+ *     filter.add(key);
+ * }
+ * edjx::bloom::save_filter("index/files.bloom", filter);
+ * ```
+ *
+ * Each warm instance loads the filter once, and lookups through
+ * FilteredKV or FilteredBucket of keys that are definitely absent return
+ * edjx::error::KVError::NotFound (or
+ * edjx::error::StorageError::ContentNotFound) without a request to the
+ * store.
+ *
+ * The wrappers do not add keys to the filter. The KV store has no
+ * conditional write, so saves from several instances would overwrite
+ * each other and drop keys, and a dropped key hides existing data.
+ * Every key read through the wrappers must therefore be in the saved
+ * filter: save a filter that contains a new key before the key is
+ * written, and expect instances to see it at the latest after `max_age`,
+ * when they reload the filter. Removing a key does not need a new filter;
+ * the stale entry only costs a false positive (one host call).
+ */
+namespace bloom {
+
+    /**
+     * @brief A Bloom filter over strings.
+     */
+    class BloomFilter {
+    public:
+        /// Lowest accepted false positive rate
+        static constexpr double MIN_FALSE_POSITIVE_RATE = 1e-9;
+        /// Highest accepted false positive rate
+        static constexpr double MAX_FALSE_POSITIVE_RATE = 0.5;
+        /// Largest number of hash functions of a filter
+        static const uint32_t MAX_HASH_COUNT = 30;
+
+        /**
+         * @brief Constructs an empty filter that cannot contain anything.
+         */
+        inline BloomFilter() : hash_count(0) {}
+
+        /**
+         * @brief Constructs an empty filter sized for the expected number
+         * of keys.
+         *
+         * @param expected_keys Number of keys the filter is sized for
+         * @param false_positive_rate Target probability that an absent
+         * key is reported as possibly present; clamped to
+         * [MIN_FALSE_POSITIVE_RATE, MAX_FALSE_POSITIVE_RATE]
+         */
+        inline BloomFilter(size_t expected_keys, double false_positive_rate) {
+            if (expected_keys == 0) {
+                expected_keys = 1;
+            }
+            if (!(false_positive_rate >= MIN_FALSE_POSITIVE_RATE)) {
+                false_positive_rate = MIN_FALSE_POSITIVE_RATE;
+            } else if (false_positive_rate > MAX_FALSE_POSITIVE_RATE) {
+                false_positive_rate = MAX_FALSE_POSITIVE_RATE;
+            }
+            const double ln2 = 0.6931471805599453;
+            double bits = -static_cast<double>(expected_keys) * std::log(false_positive_rate) / (ln2 * ln2);
+            size_t word_count = static_cast<size_t>(std::ceil(bits / 64.0));
+            words.assign(word_count > 0 ? word_count : 1, 0);
+            double k = std::round(static_cast<double>(words.size() * 64) / expected_keys * ln2);
+            hash_count = static_cast<uint32_t>(k < 1 ? 1 : (k > MAX_HASH_COUNT ? MAX_HASH_COUNT : k));
+        }
+
+        /**
+         * @brief Adds a key to the filter.
+         *
+         * @param key Key
+         */
+        inline void add(const std::string & key) {
+            uint64_t h1, h2;
+            hash(key, h1, h2);
+            uint64_t bit_count = words.size() * 64;
+            for (uint32_t i = 0; i < hash_count; i++) {
+                uint64_t bit = (h1 + i * h2) % bit_count;
+                words[bit / 64] |= uint64_t(1) << (bit % 64);
+            }
+        }
+
+        /**
+         * @brief Check whether a key may be in the filter.
+         *
+         * @param key Key
+         * @return true The key may have been added
+         * @return false The key was definitely not added
+         */
+        inline bool might_contain(const std::string & key) const {
+            if (words.empty()) {
+                return false;
+            }
+            uint64_t h1, h2;
+            hash(key, h1, h2);
+            uint64_t bit_count = words.size() * 64;
+            for (uint32_t i = 0; i < hash_count; i++) {
+                uint64_t bit = (h1 + i * h2) % bit_count;
+                if ((words[bit / 64] & (uint64_t(1) << (bit % 64))) == 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Adds all keys of another filter of the same size.
+         *
+         * @param other Filter to merge
+         * @return true The filters were merged
+         * @return false The filters have different sizes
+         */
+        inline bool merge(const BloomFilter & other) {
+            if (other.words.size() != words.size() || other.hash_count != hash_count) {
+                return false;
+            }
+            for (size_t i = 0; i < words.size(); i++) {
+                words[i] |= other.words[i];
+            }
+            return true;
+        }
+
+        /**
+         * @brief Check whether the filter has storage for keys.
+         *
+         * @return true The filter was sized or loaded
+         * @return false The filter was default-constructed
+         */
+        inline bool is_initialized() const {
+            return !words.empty();
+        }
+
+        /**
+         * @brief Returns the size of the filter in bits.
+         *
+         * @return Number of bits
+         */
+        inline size_t bit_count() const {
+            return words.size() * 64;
+        }
+
+        /**
+         * @brief Encodes the filter for storage.
+         *
+         * @param result Encoded filter
+         */
+        inline void encode(std::vector<uint8_t> & result) const {
+            result.assign(magic(), magic() + MAGIC_SIZE);
+            append_le(result, hash_count, 4);
+            append_le(result, words.size(), 8);
+            for (uint64_t word : words) {
+                append_le(result, word, 8);
+            }
+        }
+
+        /**
+         * @brief Decodes a filter produced by encode().
+         *
+         * @param data Encoded filter
+         * @return true The filter was decoded
+         * @return false The data is not a valid filter (including one with
+         * more than MAX_HASH_COUNT hash functions)
+         */
+        inline bool decode(const std::vector<uint8_t> & data) {
+            const size_t header_size = MAGIC_SIZE + 4 + 8;
+            if (data.size() < header_size || std::memcmp(data.data(), magic(), MAGIC_SIZE) != 0) {
+                return false;
+            }
+            uint64_t k = read_le(data.data() + MAGIC_SIZE, 4);
+            uint64_t word_count = read_le(data.data() + MAGIC_SIZE + 4, 8);
+            if (k == 0 || k > MAX_HASH_COUNT || word_count == 0 || (data.size() - header_size) / 8 != word_count
+                    || (data.size() - header_size) % 8 != 0) {
+                return false;
+            }
+            hash_count = static_cast<uint32_t>(k);
+            words.resize(static_cast<size_t>(word_count));
+            for (size_t i = 0; i < words.size(); i++) {
+                words[i] = read_le(data.data() + header_size + 8 * i, 8);
+            }
+            return true;
+        }
+
+    private:
+        static const size_t MAGIC_SIZE = 4;
+
+        static inline const uint8_t * magic() {
+            static const uint8_t value[MAGIC_SIZE] = { 'E', 'B', 'F', '1' };
+            return value;
+        }
+
+        static inline void hash(const std::string & key, uint64_t & h1, uint64_t & h2) {
+            // FNV-1a, then a SplitMix64 finalizer for the second hash
+            // (double hashing: bit i = h1 + i * h2).
+            uint64_t h = 0xcbf29ce484222325ULL;
+            for (unsigned char c : key) {
+                h = (h ^ c) * 0x100000001b3ULL;
+            }
+            h1 = h;
+            uint64_t z = h + 0x9e3779b97f4a7c15ULL;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            h2 = (z ^ (z >> 31)) | 1;
+        }
+
+        static inline void append_le(std::vector<uint8_t> & out, uint64_t value, int size) {
+            for (int i = 0; i < size; i++) {
+                out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+            }
+        }
+
+        static inline uint64_t read_le(const uint8_t * p, int size) {
+            uint64_t value = 0;
+            for (int i = 0; i < size; i++) {
+                value |= static_cast<uint64_t>(p[i]) << (8 * i);
+            }
+            return value;
+        }
+
+        std::vector<uint64_t> words;
+        uint32_t hash_count;
+    };
+
+    /**
+     * @brief Saves a filter under a KV key.
+     *
+     * Only one writer may save a given filter, since the KV store has no
+     * conditional write: a concurrent save would replace this one and
+     * drop its keys.
+     *
+     * @param filter_key KV key under which the filter is saved
+     * @param filter Filter
+     * @return Returns edjx::error::KVError::Success on success,
+     * some other value on failure
+     */
+    inline edjx::error::KVError save_filter(const std::string & filter_key, const BloomFilter & filter) {
+        std::vector<uint8_t> data;
+        filter.encode(data);
+        return edjx::kv::put(filter_key, data);
+    }
+
+    /**
+     * @brief Loads a filter saved by save_filter().
+     *
+     * @param result Loaded filter
+     * @param filter_key KV key under which the filter is saved
+     * @return Returns edjx::error::KVError::Success on success,
+     * edjx::error::KVError::NotFound if no filter is saved,
+     * edjx::error::KVError::Unknown if the saved value is not a filter,
+     * some other value on failure
+     */
+    inline edjx::error::KVError load_filter(BloomFilter & result, const std::string & filter_key) {
+        std::vector<uint8_t> data;
+        edjx::error::KVError err = edjx::kv::get(data, filter_key);
+        if (err != edjx::error::KVError::Success) {
+            return err;
+        }
+        return result.decode(data) ? edjx::error::KVError::Success : edjx::error::KVError::Unknown;
+    }
+
+    namespace detail {
+
+        /// A filter loaded from a KV key and reloaded after `max_age`.
+        class LoadedFilter {
+        public:
+            inline LoadedFilter(const std::string & filter_key, std::chrono::seconds max_age)
+                : filter_key(filter_key),
+                max_age(max_age),
+                loaded(false),
+                tried(false) {}
+
+            /// Returns true if the key is definitely absent.
+            inline bool is_definite_miss(const std::string & key) {
+                refresh();
+                return loaded && !filter.might_contain(key);
+            }
+
+            /// Drops the loaded filter; the next lookup loads it again.
+            inline void reload() {
+                loaded = false;
+                tried = false;
+            }
+
+        private:
+            inline void refresh() {
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                if (loaded && now - loaded_at < max_age) {
+                    return;
+                }
+                if (!loaded && tried && now - attempted < max_age) {
+                    return;
+                }
+                tried = true;
+                attempted = now;
+                // Without a saved filter nothing can be ruled out, so
+                // lookups go to the store until one has been saved.
+                BloomFilter stored;
+                loaded = load_filter(stored, filter_key) == edjx::error::KVError::Success;
+                if (loaded) {
+                    filter = stored;
+                    loaded_at = now;
+                }
+            }
+
+            std::string filter_key;
+            std::chrono::seconds max_age;
+            BloomFilter filter;
+            bool loaded;
+            std::chrono::steady_clock::time_point loaded_at;
+            bool tried;
+            std::chrono::steady_clock::time_point attempted;
+        };
+
+    }
+
+    /// Default number of keys a filter is sized for
+    const size_t DEFAULT_EXPECTED_KEYS = 100000;
+    /// Default false positive rate of a filter
+    const double DEFAULT_FALSE_POSITIVE_RATE = 0.01;
+    /// Default time after which an instance reloads a filter
+    const std::chrono::seconds DEFAULT_MAX_AGE = std::chrono::seconds(60);
+
+    /**
+     * @brief KV store lookups with a negative-lookup filter.
+     */
+    class FilteredKV {
+    public:
+        /**
+         * @brief Constructs a filtered view of the KV store.
+         *
+         * @param filter_key KV key under which the filter is saved
+         * @param max_age Time after which the filter is reloaded
+         */
+        inline explicit FilteredKV(
+            const std::string & filter_key,
+            std::chrono::seconds max_age = DEFAULT_MAX_AGE
+        ) : filter(filter_key, max_age),
+            skipped(0) {}
+
+        /**
+         * @brief Returns the value associated with the provided key, or
+         * edjx::error::KVError::NotFound without a host call if the
+         * filter rules the key out.
+         *
+         * @param result Returned value associated with the key
+         * @param key Key
+         * @return Returns edjx::error::KVError::Success on success,
+         * some other value on failure
+         */
+        inline edjx::error::KVError get(std::vector<uint8_t> & result, const std::string & key) {
+            if (filter.is_definite_miss(key)) {
+                skipped++;
+                return edjx::error::KVError::NotFound;
+            }
+            return edjx::kv::get(result, key);
+        }
+
+        /**
+         * @brief Loads the filter again on the next lookup.
+         */
+        inline void reload() {
+            filter.reload();
+        }
+
+        /**
+         * @brief Returns the number of lookups answered without a host call.
+         *
+         * @return Number of skipped lookups
+         */
+        inline uint64_t skipped_lookups() const {
+            return skipped;
+        }
+
+    private:
+        detail::LoadedFilter filter;
+        uint64_t skipped;
+    };
+
+    /**
+     * @brief Object store bucket lookups with a negative-lookup filter
+     * of file names.
+     *
+     * The filter is saved in the KV store.
+     */
+    class FilteredBucket {
+    public:
+        /**
+         * @brief Constructs a filtered view of a bucket.
+         *
+         * @param bucket_id Bucket ID
+         * @param filter_key KV key under which the filter is saved
+         * @param max_age Time after which the filter is reloaded
+         */
+        inline FilteredBucket(
+            const std::string & bucket_id,
+            const std::string & filter_key,
+            std::chrono::seconds max_age = DEFAULT_MAX_AGE
+        ) : bucket_id(bucket_id),
+            filter(filter_key, max_age),
+            skipped(0) {}
+
+        /**
+         * @brief Returns a file, or edjx::error::StorageError::ContentNotFound
+         * without a host call if the filter rules the file out.
+         *
+         * @param result Result File
+         * @param file_name File name
+         * @return edjx::error::StorageError::Success on success,
+         * some other value on failure
+         */
+        inline edjx::error::StorageError get(edjx::storage::StorageResponse & result, const std::string & file_name) {
+            if (filter.is_definite_miss(file_name)) {
+                skipped++;
+                return edjx::error::StorageError::ContentNotFound;
+            }
+            return edjx::storage::get(result, bucket_id, file_name);
+        }
+
+        /**
+         * @brief Loads the filter again on the next lookup.
+         */
+        inline void reload() {
+            filter.reload();
+        }
+
+        /**
+         * @brief Returns the number of lookups answered without a host call.
+         *
+         * @return Number of skipped lookups
+         */
+        inline uint64_t skipped_lookups() const {
+            return skipped;
+        }
+
+    private:
+        std::string bucket_id;
+        detail::LoadedFilter filter;
+        uint64_t skipped;
+    };
+
+}}
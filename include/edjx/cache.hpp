@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <strings.h>
+
+#include "error.hpp"
+#include "response.hpp"
+#include "storage.hpp"
+#include "stream.hpp"
+
+namespace edjx {
+namespace storage {
+
+    /**
+     * @brief A file cached by CachedBucket.
+     *
+     * Cached files are shared and immutable; a file stays valid for as long
+     * as it is referenced, even if the cache evicts or replaces it.
+     */
+    struct CachedFile {
+        /// Headers returned by edjx::storage::get()
+        std::map<std::string, std::string> headers;
+        /// Contents of the file
+        std::vector<uint8_t> body;
+        /// Default version of the file when it was read
+        std::string version;
+    };
+
+    /**
+     * @brief Cache counters of a CachedBucket.
+     */
+    struct CacheStats {
+        /// Requests served from the cache
+        uint64_t hits;
+        /// Requests that read the file from the store
+        uint64_t misses;
+        /// Files removed to stay within the byte budget
+        uint64_t evictions;
+        /// Bytes of file contents held by the cache
+        size_t bytes;
+        /// Number of cached files
+        size_t entries;
+
+        inline CacheStats() : hits(0), misses(0), evictions(0), bytes(0), entries(0) {}
+
+        /**
+         * @brief Returns the share of requests served from the cache.
+         *
+         * @return Hit rate between 0 and 1
+         */
+        inline double hit_rate() const {
+            uint64_t total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+        }
+    };
+
+    /**
+     * @brief A bucket of the EDJX Object Store with a cache of file
+     * contents that lives as long as the instance.
+     *
+     * Least recently used files are evicted when the cached contents exceed
+     * the byte budget. Every get() checks the default version of the file
+     * with edjx::storage::get_attributes(), and the contents are read again
+     * if the version changed, so a file is never served from the cache
+     * after a new version was put. Files without a default version cannot
+     * be revalidated and are not cached.
+     *
+     * ```
+     * static edjx::storage::CachedBucket assets("assets-bucket-id");
+     * std::shared_ptr<const edjx::storage::CachedFile> file;
+     * if (assets.get(file, "app.js") == edjx::error::StorageError::Success) {
+     *     edjx::storage::send_cached(response, *file);
+     * }
+     * ```
+     */
+    class CachedBucket {
+    public:
+        /// Default byte budget for cached file contents
+        static const size_t DEFAULT_BUDGET = 8 * 1024 * 1024;
+
+        /**
+         * @brief Constructs a cached view of a bucket.
+         *
+         * @param bucket_id Bucket ID
+         * @param budget Largest total size of cached file contents in bytes
+         */
+        inline explicit CachedBucket(const std::string & bucket_id, size_t budget = DEFAULT_BUDGET)
+            : bucket_id(bucket_id),
+            budget(budget) {}
+
+        /**
+         * @brief Returns a file, from the cache if the cached version is
+         * still current.
+         *
+         * @param result The file
+         * @param file_name File name
+         * @return edjx::error::StorageError::Success on success,
+         * some other value on failure
+         */
+        inline edjx::error::StorageError get(
+            std::shared_ptr<const CachedFile> & result,
+            const std::string & file_name
+        ) {
+            FileAttributes attributes;
+            edjx::error::StorageError err = get_attributes(attributes, bucket_id, file_name);
+            if (err != edjx::error::StorageError::Success) {
+                return err;
+            }
+            const std::string & version = attributes.default_version;
+            bool cacheable = attributes.default_version_present && !version.empty();
+
+            auto found = index.find(file_name);
+            if (found != index.end()) {
+                if (cacheable && found->second->second->version == version) {
+                    lru.splice(lru.begin(), lru, found->second);
+                    stats.hits++;
+                    result = found->second->second;
+                    return edjx::error::StorageError::Success;
+                }
+                erase(found);
+            }
+
+            stats.misses++;
+            StorageResponse response;
+            err = edjx::storage::get(response, bucket_id, file_name);
+            if (err != edjx::error::StorageError::Success) {
+                return err;
+            }
+            std::shared_ptr<CachedFile> file = std::make_shared<CachedFile>();
+            file->headers = response.get_headers();
+            file->version = version;
+            edjx::error::StreamError read_err = response.read_body(file->body);
+            if (read_err != edjx::error::StreamError::Success && read_err != edjx::error::StreamError::EndOfStream) {
+                return edjx::error::StorageError::StorageChannelClosed;
+            }
+            result = file;
+            if (cacheable && file->body.size() <= budget) {
+                insert(file_name, file);
+            }
+            return edjx::error::StorageError::Success;
+        }
+
+        /**
+         * @brief Removes a file from the cache.
+         *
+         * @param file_name File name
+         */
+        inline void invalidate(const std::string & file_name) {
+            auto found = index.find(file_name);
+            if (found != index.end()) {
+                erase(found);
+            }
+        }
+
+        /**
+         * @brief Removes all files from the cache. Counters are kept.
+         */
+        inline void clear() {
+            lru.clear();
+            index.clear();
+            stats.bytes = 0;
+            stats.entries = 0;
+        }
+
+        /**
+         * @brief Returns the cache counters.
+         *
+         * @return Counters
+         */
+        inline const CacheStats & get_stats() const {
+            return stats;
+        }
+
+        /**
+         * @brief Returns the bucket ID.
+         *
+         * @return Bucket ID
+         */
+        inline const std::string & get_bucket_id() const {
+            return bucket_id;
+        }
+
+    private:
+        typedef std::list<std::pair<std::string, std::shared_ptr<const CachedFile>>> Lru;
+        typedef std::unordered_map<std::string, Lru::iterator> Index;
+
+        inline void insert(const std::string & file_name, const std::shared_ptr<const CachedFile> & file) {
+            while (!lru.empty() && stats.bytes + file->body.size() > budget) {
+                erase(index.find(lru.back().first));
+                stats.evictions++;
+            }
+            lru.emplace_front(file_name, file);
+            index[file_name] = lru.begin();
+            stats.bytes += file->body.size();
+            stats.entries++;
+        }
+
+        inline void erase(Index::iterator position) {
+            stats.bytes -= position->second->second->body.size();
+            stats.entries--;
+            lru.erase(position->second);
+            index.erase(position);
+        }
+
+        std::string bucket_id;
+        size_t budget;
+        Lru lru;
+        Index index;
+        CacheStats stats;
+    };
+
+    /**
+     * @brief Sends a cached file as the response body.
+     *
+     * The contents are written to the response stream straight from the
+     * cache, without being copied into the response object. The
+     * Content-Type of the file is used if the response has none.
+     *
+     * @param response Response with status and headers set
+     * @param file Cached file
+     * @return Returns edjx::error::HttpError::Success on success,
+     * some other value on failure.
+     */
+    inline edjx::error::HttpError send_cached(edjx::response::HttpResponse & response, const CachedFile & file) {
+        if (response.get_headers().find("Content-Type") == response.get_headers().end()) {
+            for (const auto & header : file.headers) {
+                if (strcasecmp(header.first.c_str(), "Content-Type") == 0) {
+                    response.set_header("Content-Type", header.second);
+                    break;
+                }
+            }
+        }
+        edjx::stream::WriteStream write_stream;
+        edjx::error::HttpError err = response.send_streaming(write_stream);
+        if (err != edjx::error::HttpError::Success) {
+            return err;
+        }
+        if (!file.body.empty()
+                && write_stream.write_chunk(file.body.data(), file.body.size()) != edjx::error::StreamError::Success) {
+            write_stream.abort();
+            return edjx::error::HttpError::HTTPChannelClosed;
+        }
+        if (write_stream.close() != edjx::error::StreamError::Success) {
+            return edjx::error::HttpError::HTTPChannelClosed;
+        }
+        return edjx::error::HttpError::Success;
+    }
+
+}}
@@ -0,0 +1,469 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "error.hpp"
+#include "stream.hpp"
+
+namespace edjx {
+
+/**
+ * @brief Message digests computed while data is streamed.
+ *
+ * The hashing stages hash every chunk as it passes from one stream to
+ * another, so a digest (e.g., for an ETag or an integrity check) does not
+ * require reading an object a second time.
+ *
+ * ```
+ * edjx::digest::HashingWriteStream<edjx::digest::Sha256> upload(write_stream);
+ * upload.write_chunk(bytes.data(), bytes.size());
+ * upload.close();
+ * response.set_etag(edjx::digest::to_hex(upload.digest()));
+ * ```
+ */
+namespace digest {
+
+    /**
+     * @brief Incremental SHA-256 (FIPS 180-4).
+     */
+    class Sha256 {
+    public:
+        /// Size of the digest in bytes
+        static const size_t DIGEST_SIZE = 32;
+        /// Digest value
+        typedef std::vector<uint8_t> Digest;
+
+        inline Sha256() {
+            reset();
+        }
+
+        /**
+         * @brief Starts a new digest.
+         */
+        inline void reset() {
+            static const uint32_t initial[8] = {
+                0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+            };
+            std::memcpy(state, initial, sizeof(state));
+            length = 0;
+            buffered = 0;
+        }
+
+        /**
+         * @brief Hashes more bytes.
+         *
+         * @param data Pointer to the bytes
+         * @param size Number of bytes
+         */
+        inline void update(const uint8_t * data, size_t size) {
+            length += size;
+            if (buffered > 0) {
+                size_t n = BLOCK_SIZE - buffered < size ? BLOCK_SIZE - buffered : size;
+                std::memcpy(buffer + buffered, data, n);
+                buffered += n;
+                data += n;
+                size -= n;
+                if (buffered < BLOCK_SIZE) {
+                    return;
+                }
+                compress(buffer);
+                buffered = 0;
+            }
+            // Whole blocks are hashed in place, without copying.
+            while (size >= BLOCK_SIZE) {
+                compress(data);
+                data += BLOCK_SIZE;
+                size -= BLOCK_SIZE;
+            }
+            std::memcpy(buffer, data, size);
+            buffered = size;
+        }
+
+        /**
+         * @brief Finishes the digest. Call reset() before reusing the object.
+         *
+         * @return The digest (DIGEST_SIZE bytes)
+         */
+        inline Digest finish() {
+            uint64_t bits = length * 8;
+            static const uint8_t padding[BLOCK_SIZE] = { 0x80 };
+            size_t pad = buffered < 56 ? 56 - buffered : 120 - buffered;
+            update(padding, pad);
+            uint8_t encoded[8];
+            for (int i = 0; i < 8; i++) {
+                encoded[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+            }
+            update(encoded, 8);
+            Digest result(DIGEST_SIZE);
+            for (int i = 0; i < 8; i++) {
+                result[4 * i] = static_cast<uint8_t>(state[i] >> 24);
+                result[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+                result[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+                result[4 * i + 3] = static_cast<uint8_t>(state[i]);
+            }
+            return result;
+        }
+
+    private:
+        static const size_t BLOCK_SIZE = 64;
+
+        static inline uint32_t rotr(uint32_t x, unsigned n) {
+            return (x >> n) | (x << (32 - n));
+        }
+
+        inline void compress(const uint8_t * block) {
+            static const uint32_t k[64] = {
+                0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+                0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+                0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+                0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+                0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+                0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+            };
+            uint32_t w[64];
+            for (int i = 0; i < 16; i++) {
+                w[i] = (static_cast<uint32_t>(block[4 * i]) << 24)
+                    | (static_cast<uint32_t>(block[4 * i + 1]) << 16)
+                    | (static_cast<uint32_t>(block[4 * i + 2]) << 8)
+                    | static_cast<uint32_t>(block[4 * i + 3]);
+            }
+            for (int i = 16; i < 64; i++) {
+                uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int i = 0; i < 64; i++) {
+                uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+                uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+
+        uint32_t state[8];
+        uint64_t length;
+        uint8_t buffer[BLOCK_SIZE];
+        size_t buffered;
+    };
+
+    /**
+     * @brief Incremental MD5 (RFC 1321).
+     *
+     * MD5 is not collision resistant; use it only where a protocol or
+     * an existing system requires it (e.g., Content-MD5).
+     */
+    class Md5 {
+    public:
+        /// Size of the digest in bytes
+        static const size_t DIGEST_SIZE = 16;
+        /// Digest value
+        typedef std::vector<uint8_t> Digest;
+
+        inline Md5() {
+            reset();
+        }
+
+        /**
+         * @brief Starts a new digest.
+         */
+        inline void reset() {
+            state[0] = 0x67452301;
+            state[1] = 0xefcdab89;
+            state[2] = 0x98badcfe;
+            state[3] = 0x10325476;
+            length = 0;
+            buffered = 0;
+        }
+
+        /**
+         * @brief Hashes more bytes.
+         *
+         * @param data Pointer to the bytes
+         * @param size Number of bytes
+         */
+        inline void update(const uint8_t * data, size_t size) {
+            length += size;
+            if (buffered > 0) {
+                size_t n = BLOCK_SIZE - buffered < size ? BLOCK_SIZE - buffered : size;
+                std::memcpy(buffer + buffered, data, n);
+                buffered += n;
+                data += n;
+                size -= n;
+                if (buffered < BLOCK_SIZE) {
+                    return;
+                }
+                compress(buffer);
+                buffered = 0;
+            }
+            while (size >= BLOCK_SIZE) {
+                compress(data);
+                data += BLOCK_SIZE;
+                size -= BLOCK_SIZE;
+            }
+            std::memcpy(buffer, data, size);
+            buffered = size;
+        }
+
+        /**
+         * @brief Finishes the digest. Call reset() before reusing the object.
+         *
+         * @return The digest (DIGEST_SIZE bytes)
+         */
+        inline Digest finish() {
+            uint64_t bits = length * 8;
+            static const uint8_t padding[BLOCK_SIZE] = { 0x80 };
+            size_t pad = buffered < 56 ? 56 - buffered : 120 - buffered;
+            update(padding, pad);
+            uint8_t encoded[8];
+            for (int i = 0; i < 8; i++) {
+                encoded[i] = static_cast<uint8_t>(bits >> (8 * i));
+            }
+            update(encoded, 8);
+            Digest result(DIGEST_SIZE);
+            for (int i = 0; i < 4; i++) {
+                result[4 * i] = static_cast<uint8_t>(state[i]);
+                result[4 * i + 1] = static_cast<uint8_t>(state[i] >> 8);
+                result[4 * i + 2] = static_cast<uint8_t>(state[i] >> 16);
+                result[4 * i + 3] = static_cast<uint8_t>(state[i] >> 24);
+            }
+            return result;
+        }
+
+    private:
+        static const size_t BLOCK_SIZE = 64;
+
+        static inline uint32_t rotl(uint32_t x, unsigned n) {
+            return (x << n) | (x >> (32 - n));
+        }
+
+        static inline void step(uint32_t & a, uint32_t & b, uint32_t & c, uint32_t & d, uint32_t sum, unsigned shift) {
+            uint32_t next = b + rotl(a + sum, shift);
+            a = d;
+            d = c;
+            c = b;
+            b = next;
+        }
+
+        inline void compress(const uint8_t * block) {
+            static const uint32_t k[64] = {
+                0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+                0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+                0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+                0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+                0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+                0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+                0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+                0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+            };
+            static const unsigned shifts[16] = { 7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21 };
+            uint32_t m[16];
+            for (int i = 0; i < 16; i++) {
+                m[i] = static_cast<uint32_t>(block[4 * i])
+                    | (static_cast<uint32_t>(block[4 * i + 1]) << 8)
+                    | (static_cast<uint32_t>(block[4 * i + 2]) << 16)
+                    | (static_cast<uint32_t>(block[4 * i + 3]) << 24);
+            }
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            // One loop per round keeps the round function out of the
+            // inner loop.
+            for (int i = 0; i < 16; i++) {
+                step(a, b, c, d, ((b & c) | (~b & d)) + k[i] + m[i], shifts[i % 4]);
+            }
+            for (int i = 16; i < 32; i++) {
+                step(a, b, c, d, ((d & b) | (~d & c)) + k[i] + m[(5 * i + 1) % 16], shifts[4 + i % 4]);
+            }
+            for (int i = 32; i < 48; i++) {
+                step(a, b, c, d, (b ^ c ^ d) + k[i] + m[(3 * i + 5) % 16], shifts[8 + i % 4]);
+            }
+            for (int i = 48; i < 64; i++) {
+                step(a, b, c, d, (c ^ (b | ~d)) + k[i] + m[(7 * i) % 16], shifts[12 + i % 4]);
+            }
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+        }
+
+        uint32_t state[4];
+        uint64_t length;
+        uint8_t buffer[BLOCK_SIZE];
+        size_t buffered;
+    };
+
+    /**
+     * @brief Formats a digest as lowercase hexadecimal text.
+     *
+     * @param digest Digest bytes
+     * @return Hexadecimal text
+     */
+    inline std::string to_hex(const std::vector<uint8_t> & digest) {
+        static const char digits[] = "0123456789abcdef";
+        std::string result(digest.size() * 2, '0');
+        for (size_t i = 0; i < digest.size(); i++) {
+            result[2 * i] = digits[digest[i] >> 4];
+            result[2 * i + 1] = digits[digest[i] & 0x0f];
+        }
+        return result;
+    }
+
+    /**
+     * @brief A write stream wrapper that hashes every chunk it writes.
+     */
+    template <typename Hash>
+    class HashingWriteStream {
+    public:
+        /**
+         * @brief Constructs a hashing writer on top of a write stream.
+         *
+         * @param write_stream Underlying write stream
+         */
+        inline explicit HashingWriteStream(edjx::stream::WriteStream & write_stream)
+            : write_stream(write_stream) {}
+
+        /**
+         * @brief Hashes a chunk and writes it into the stream.
+         *
+         * @param data Pointer to the bytes
+         * @param size Number of bytes
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write_chunk(const uint8_t * data, size_t size) {
+            hash.update(data, size);
+            return write_stream.write_chunk(data, size);
+        }
+
+        /**
+         * @brief Hashes a chunk and writes it into the stream.
+         *
+         * @param bytes A chunk of binary data
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write_chunk(const std::vector<uint8_t> & bytes) {
+            return write_chunk(bytes.data(), bytes.size());
+        }
+
+        /**
+         * @brief Hashes a chunk of text and writes it into the stream.
+         *
+         * @param text A chunk of text
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write_chunk(const std::string & text) {
+            return write_chunk(reinterpret_cast<const uint8_t *>(text.data()), text.size());
+        }
+
+        /**
+         * @brief Closes the underlying stream.
+         *
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError close() {
+            return write_stream.close();
+        }
+
+        /**
+         * @brief Returns the digest of everything written so far.
+         *
+         * @return Digest
+         */
+        inline typename Hash::Digest digest() const {
+            Hash copy = hash;
+            return copy.finish();
+        }
+
+    private:
+        edjx::stream::WriteStream & write_stream;
+        Hash hash;
+    };
+
+    /**
+     * @brief Pipes a read stream into a write stream and hashes the data
+     * on the way.
+     *
+     * Unlike edjx::stream::ReadStream::pipe_to(), which the host performs
+     * without involving the function, the data passes through the memory
+     * of the function one chunk at a time. After all data is transmitted,
+     * both streams are closed.
+     *
+     * @param read_stream Source
+     * @param write_stream Destination
+     * @param hash Hash that receives all piped bytes
+     * @return Returns edjx::error::StreamError::Success on success,
+     * some other value on failure.
+     */
+    template <typename Hash>
+    inline edjx::error::StreamError pipe_hashed(
+        edjx::stream::ReadStream & read_stream,
+        edjx::stream::WriteStream & write_stream,
+        Hash & hash
+    ) {
+        std::vector<uint8_t> chunk;
+        while (true) {
+            edjx::error::StreamError err = read_stream.read_chunk(chunk);
+            if (err == edjx::error::StreamError::EndOfStream) {
+                break;
+            }
+            if (err == edjx::error::StreamError::Success) {
+                hash.update(chunk.data(), chunk.size());
+                err = write_stream.write_chunk(chunk.data(), chunk.size());
+            }
+            if (err != edjx::error::StreamError::Success) {
+                write_stream.abort();
+                return err;
+            }
+        }
+        read_stream.close();
+        return write_stream.close();
+    }
+
+    /**
+     * @brief Reads a stream to its end and returns the digest of its data.
+     *
+     * @param read_stream Stream to hash
+     * @param hash Hash that receives all bytes
+     * @return Returns edjx::error::StreamError::Success on success,
+     * some other value on failure.
+     */
+    template <typename Hash>
+    inline edjx::error::StreamError hash_stream(edjx::stream::ReadStream & read_stream, Hash & hash) {
+        std::vector<uint8_t> chunk;
+        while (true) {
+            edjx::error::StreamError err = read_stream.read_chunk(chunk);
+            if (err == edjx::error::StreamError::EndOfStream) {
+                return edjx::error::StreamError::Success;
+            }
+            if (err != edjx::error::StreamError::Success) {
+                return err;
+            }
+            hash.update(chunk.data(), chunk.size());
+        }
+    }
+
+}}
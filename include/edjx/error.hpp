@@ -50,10 +50,12 @@ namespace error {
     /**
      * @brief Returns a string representation of HttpError
      * 
+     * The returned string is a constant and must not be freed.
+     * 
      * @param e Error value
      * @return String representation of the error value
      */
-    inline std::string to_string(HttpError e) {
+    inline const char * to_c_string(HttpError e) {
         switch (e) {
             case HttpError::Success:
                 return "HTTP: success";
@@ -89,6 +91,17 @@ namespace error {
             case HttpError::HTTPChannelClosed:
                 return "HTTP: Channel closed";
         }
+        return "HTTP: unknown error";
+    }
+
+    /**
+     * @brief Returns a string representation of HttpError
+     * 
+     * @param e Error value
+     * @return String representation of the error value
+     */
+    inline std::string to_string(HttpError e) {
+        return to_c_string(e);
     }
 
     /**
@@ -109,10 +122,12 @@ namespace error {
     /**
      * @brief Returns a string representation of KVError
      * 
+     * The returned string is a constant and must not be freed.
+     * 
      * @param e Error value
      * @return String representation of the error value
      */
-    inline std::string to_string(KVError e) {
+    inline const char * to_c_string(KVError e) {
         switch (e) {
             case KVError::Success:
                 return "KV: success";
@@ -123,6 +138,17 @@ namespace error {
             case KVError::UnAuthorized:
                 return "KV: unauthorized";
         }
+        return "KV: unknown";
+    }
+
+    /**
+     * @brief Returns a string representation of KVError
+     * 
+     * @param e Error value
+     * @return String representation of the error value
+     */
+    inline std::string to_string(KVError e) {
+        return to_c_string(e);
     }
 
     /**
@@ -166,10 +192,12 @@ namespace error {
     /**
      * @brief Returns a string representation of StorageError
      * 
+     * The returned string is a constant and must not be freed.
+     * 
      * @param e Error value
      * @return String representation of the error value
      */
-    inline std::string to_string(StorageError e) {
+    inline const char * to_c_string(StorageError e) {
         switch (e) {
             case StorageError::Success:
                 return "Storage: success";
@@ -203,6 +231,17 @@ namespace error {
             case StorageError::StorageChannelClosed:
                 return "Storage: Storage channel closed";
         }
+        return "Storage: unknown error";
+    }
+
+    /**
+     * @brief Returns a string representation of StorageError
+     * 
+     * @param e Error value
+     * @return String representation of the error value
+     */
+    inline std::string to_string(StorageError e) {
+        return to_c_string(e);
     }
 
     /**
@@ -263,7 +302,15 @@ namespace error {
         StreamChunkTooLarge
     };
 
-    inline std::string to_string(StreamError e) {
+    /**
+     * @brief Returns a string representation of StreamError
+     * 
+     * The returned string is a constant and must not be freed.
+     * 
+     * @param e Error value
+     * @return String representation of the error value
+     */
+    inline const char * to_c_string(StreamError e) {
         switch (e) {
             case StreamError::Success:
                 return "Stream: success";
@@ -286,6 +333,77 @@ namespace error {
             case StreamError::StreamChunkTooLarge:
                 return "Stream: stream chunk is too large";
         }
+        return "Stream: unknown error";
+    }
+
+    inline std::string to_string(StreamError e) {
+        return to_c_string(e);
+    }
+
+    /**
+     * @brief Enum that describes values returned by JSON functions.
+     */
+    enum class JsonError {
+        /// JSON operation completed successfully.
+        Success = 0,
+        /// There are no more elements or fields in the array or object.
+        EndOfContainer,
+        /// Input ended in the middle of a JSON value.
+        UnexpectedEnd,
+        /// Input is not valid JSON.
+        SyntaxError,
+        /// JSON value has a different type than requested.
+        TypeMismatch,
+        /// Object does not contain the requested field.
+        FieldNotFound,
+        /// Array does not contain the requested index.
+        IndexOutOfRange,
+        /// Number does not fit into the requested type.
+        NumberOutOfRange,
+        /// String contains an invalid escape sequence.
+        InvalidEscape
+    };
+
+    /**
+     * @brief Returns a string representation of JsonError
+     * 
+     * The returned string is a constant and must not be freed.
+     * 
+     * @param e Error value
+     * @return String representation of the error value
+     */
+    inline const char * to_c_string(JsonError e) {
+        switch (e) {
+            case JsonError::Success:
+                return "JSON: success";
+            case JsonError::EndOfContainer:
+                return "JSON: end of array or object";
+            case JsonError::UnexpectedEnd:
+                return "JSON: unexpected end of input";
+            case JsonError::SyntaxError:
+                return "JSON: syntax error";
+            case JsonError::TypeMismatch:
+                return "JSON: type mismatch";
+            case JsonError::FieldNotFound:
+                return "JSON: field not found";
+            case JsonError::IndexOutOfRange:
+                return "JSON: index out of range";
+            case JsonError::NumberOutOfRange:
+                return "JSON: number out of range";
+            case JsonError::InvalidEscape:
+                return "JSON: invalid escape sequence";
+        }
+        return "JSON: unknown error";
+    }
+
+    /**
+     * @brief Returns a string representation of JsonError
+     * 
+     * @param e Error value
+     * @return String representation of the error value
+     */
+    inline std::string to_string(JsonError e) {
+        return to_c_string(e);
     }
 
 }}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace edjx {
+
+    /**
+     * @brief Either a value or an error, returned by the value-returning
+     * overloads of the SDK functions.
+     *
+     * The value is moved into the result, so callers do not need to
+     * construct an object first and pass it as an out-parameter.
+     *
+     * ```
+     * auto file = edjx::storage::get(bucket_id, "index.html");
+     * if (!file) {
+     *     return file.error();
+     * }
+     * file->read_body(body);
+     * ```
+     *
+     * @tparam T Type of the value
+     * @tparam E Error enum; its `Success` value is never stored as an error
+     */
+    template <typename T, typename E>
+    class Expected {
+    public:
+        /**
+         * @brief Constructs a result holding a value.
+         *
+         * @param value Value
+         */
+        inline Expected(T && value) : ok(true) {
+            new (&storage.value) T(std::move(value));
+        }
+
+        /**
+         * @brief Constructs a result holding a copy of a value.
+         *
+         * @param value Value
+         */
+        inline Expected(const T & value) : ok(true) {
+            new (&storage.value) T(value);
+        }
+
+        /**
+         * @brief Constructs a result holding an error.
+         *
+         * Passing `E::Success` aborts the function, since the result
+         * would be neither a value nor an error.
+         *
+         * @param error Error, other than `E::Success`
+         */
+        inline Expected(E error) : ok(false) {
+            if (error == E::Success) {
+                std::abort();
+            }
+            storage.error = error;
+        }
+
+        inline Expected(Expected && other) : ok(other.ok) {
+            if (ok) {
+                new (&storage.value) T(std::move(other.storage.value));
+            } else {
+                storage.error = other.storage.error;
+            }
+        }
+
+        inline Expected(const Expected & other) : ok(other.ok) {
+            if (ok) {
+                new (&storage.value) T(other.storage.value);
+            } else {
+                storage.error = other.storage.error;
+            }
+        }
+
+        inline Expected & operator=(Expected other) {
+            destroy();
+            ok = other.ok;
+            if (ok) {
+                new (&storage.value) T(std::move(other.storage.value));
+            } else {
+                storage.error = other.storage.error;
+            }
+            return *this;
+        }
+
+        inline ~Expected() {
+            destroy();
+        }
+
+        /**
+         * @brief Check whether the result holds a value.
+         *
+         * @return true The operation was successful
+         * @return false The result holds an error
+         */
+        inline bool has_value() const {
+            return ok;
+        }
+
+        inline explicit operator bool() const {
+            return ok;
+        }
+
+        /**
+         * @brief Returns the value. Calling this (or `*`, `->`) on
+         * a result that holds an error aborts the function.
+         *
+         * @return The value
+         */
+        inline T & value() & {
+            check();
+            return storage.value;
+        }
+
+        inline const T & value() const & {
+            check();
+            return storage.value;
+        }
+
+        inline T && value() && {
+            check();
+            return std::move(storage.value);
+        }
+
+        inline T & operator*() & {
+            check();
+            return storage.value;
+        }
+
+        inline const T & operator*() const & {
+            check();
+            return storage.value;
+        }
+
+        inline T && operator*() && {
+            check();
+            return std::move(storage.value);
+        }
+
+        inline T * operator->() {
+            check();
+            return &storage.value;
+        }
+
+        inline const T * operator->() const {
+            check();
+            return &storage.value;
+        }
+
+        /**
+         * @brief Returns the error, or `E::Success` if the result holds
+         * a value.
+         *
+         * @return The error
+         */
+        inline E error() const {
+            return ok ? E::Success : storage.error;
+        }
+
+        /**
+         * @brief Returns the value, or a fallback if the result holds
+         * an error.
+         *
+         * @param fallback Value returned on error
+         * @return The value or the fallback
+         */
+        inline T value_or(T fallback) const & {
+            return ok ? storage.value : fallback;
+        }
+
+        inline T value_or(T fallback) && {
+            return ok ? std::move(storage.value) : std::move(fallback);
+        }
+
+    private:
+        inline void check() const {
+            if (!ok) {
+                std::abort();
+            }
+        }
+
+        inline void destroy() {
+            if (ok) {
+                storage.value.~T();
+            }
+        }
+
+        union Storage {
+            T value;
+            E error;
+
+            inline Storage() {}
+            inline ~Storage() {}
+        } storage;
+        bool ok;
+    };
+
+}
@@ -4,7 +4,9 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <utility>
 
+#include "expected.hpp"
 #include "http.hpp"
 #include "stream.hpp"
 #include "error.hpp"
@@ -85,6 +87,20 @@ namespace fetch {
          * some other value on failure.
          */
         edjx::error::HttpError get_fetch_response(FetchResponse & result);
+
+        /**
+         * @brief Get the server's response
+         * 
+         * @return Server's response, or the error on failure
+         */
+        inline Expected<FetchResponse, edjx::error::HttpError> get_fetch_response() {
+            FetchResponse result;
+            edjx::error::HttpError err = get_fetch_response(result);
+            if (err != edjx::error::HttpError::Success) {
+                return err;
+            }
+            return result;
+        }
     };
 
     /**
@@ -228,6 +244,21 @@ namespace fetch {
          */
         edjx::error::HttpError send(FetchResponse & response);
 
+        /**
+         * @brief Sends the request to the server, and returns after the
+         * response is received or an error occurs.
+         * 
+         * @return Server's response, or the error on failure
+         */
+        inline Expected<FetchResponse, edjx::error::HttpError> send() {
+            FetchResponse response;
+            edjx::error::HttpError err = send(response);
+            if (err != edjx::error::HttpError::Success) {
+                return err;
+            }
+            return response;
+        }
+
         /**
          * @brief Starts streaming an HTTP Fetch request to the server.
          * This method returns a `FetchResponsePending` object and an `edjx::stream::WriteStream` object.
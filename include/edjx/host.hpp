@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "error.hpp"
+
+// Host functions used by the header-only parts of the SDK. These are the
+// same imports (and internal helpers) that libedjx.a uses; they are not
+// meant to be called from serverless functions directly.
+
+#if defined(__wasm__)
+#define EDJX_HOST_IMPORT(module, name) __attribute__((import_module(module), import_name(name)))
+#else
+#define EDJX_HOST_IMPORT(module, name)
+#endif
+
+extern "C" {
+
+    EDJX_HOST_IMPORT("request", "http_cur_req_get_method")
+    int32_t http_cur_req_get_method();
+
+    EDJX_HOST_IMPORT("request", "http_cur_req_get_uri")
+    int32_t http_cur_req_get_uri(int32_t * error_code);
+
+    EDJX_HOST_IMPORT("request", "http_cur_req_get_header_value")
+    int32_t http_cur_req_get_header_value(const uint8_t * name, uint32_t name_len, int32_t * error_code);
+
+    EDJX_HOST_IMPORT("stream", "host_write_chunk")
+    int32_t host_write_chunk(uint32_t sd, const uint8_t * data, uint32_t data_len, int32_t * error_code);
+
+    EDJX_HOST_IMPORT("kv", "host_kv_get")
+    int32_t host_kv_get(const uint8_t * key, uint32_t key_len, uint32_t * sd, int32_t * error_code);
+
+}
+
+namespace edjx {
+
+/// Access to results of host calls.
+namespace result {
+
+    /**
+     * @brief Copies the result of the last host call into `result`.
+     *
+     * @param result Result bytes
+     * @param size Result size returned by the host call
+     * @return true The result was retrieved
+     * @return false The host did not provide the result
+     */
+    bool get_result_bytes(std::vector<uint8_t> & result, int size);
+
+}
+
+namespace stream {
+
+    /**
+     * @brief Returns the number of bytes left in a host value stream.
+     *
+     * @param sd Stream descriptor
+     * @return Number of bytes
+     */
+    uint32_t stream_size(uint32_t sd);
+
+    /**
+     * @brief Reads up to `size` bytes from a host value stream.
+     *
+     * @param sd Stream descriptor
+     * @param buffer Destination
+     * @param size Number of bytes to read
+     * @return Number of bytes read
+     */
+    uint32_t stream_read_n(uint32_t sd, uint8_t * buffer, uint32_t size);
+
+    /**
+     * @brief Releases a host value stream.
+     *
+     * @param sd Stream descriptor
+     */
+    void stream_drop(uint32_t sd);
+
+}
+
+/// Conversions of host error codes.
+namespace host {
+
+    /**
+     * @brief Converts an error code of the HTTP host functions
+     * into an edjx::error::HttpError.
+     *
+     * @param code Host error code
+     * @return HTTP error value
+     */
+    inline edjx::error::HttpError to_http_error(int32_t code) {
+        using edjx::error::HttpError;
+        switch (code) {
+            case 0: return HttpError::HTTPInvalidMethod;
+            case 1: return HttpError::HTTPInvalidStatusCode;
+            case 2: return HttpError::HTTPInvalidVersion;
+            case 3: return HttpError::HeaderInvalidName;
+            case 4: return HttpError::HeaderInvalidValue;
+            case 5:
+            case 6: return HttpError::UriInvalid;
+            case 7: return HttpError::HTTPBodyTooLarge;
+            case 8: return HttpError::UriTooLarge;
+            case 9: return HttpError::HeaderTooLargeName;
+            case 10: return HttpError::HeaderTooLargeValue;
+            case 28: return HttpError::HTTPFetchResponseNotFound;
+            case 29: return HttpError::HTTPFetchRequestFailed;
+            case 31: return HttpError::HTTPChannelClosed;
+            default: return HttpError::UnknownError;
+        }
+    }
+
+    /**
+     * @brief Converts an error code of the KV host functions
+     * into an edjx::error::KVError.
+     *
+     * @param code Host error code
+     * @return KV error value
+     */
+    inline edjx::error::KVError to_kv_error(int32_t code) {
+        switch (code) {
+            case 19: return edjx::error::KVError::NotFound;
+            case 20: return edjx::error::KVError::UnAuthorized;
+            default: return edjx::error::KVError::Unknown;
+        }
+    }
+
+    /**
+     * @brief Converts an error code of the stream host functions
+     * into an edjx::error::StreamError.
+     *
+     * @param code Host error code
+     * @return Stream error value
+     */
+    inline edjx::error::StreamError to_stream_error(int32_t code) {
+        if (code >= 22 && code <= 27) {
+            return static_cast<edjx::error::StreamError>(code - 18);
+        }
+        return edjx::error::StreamError::Unknown;
+    }
+
+}}
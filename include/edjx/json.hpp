@@ -0,0 +1,1157 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "error.hpp"
+#include "simd.hpp"
+#include "stream.hpp"
+
+namespace edjx {
+
+/**
+ * @brief Allocation-light JSON reader and streaming JSON writer.
+ *
+ * The reader works on demand: edjx::json::parse() only checks the
+ * structure of the document (strings, brackets and braces), and values are
+ * decoded when they are accessed. Values are views into the parsed buffer,
+ * so the buffer must outlive them.
+ *
+ * The writer appends to an internal buffer, and it can flush the buffer
+ * into an edjx::stream::WriteStream whenever it grows past a threshold.
+ */
+namespace json {
+
+    /**
+     * @brief Maximum nesting depth of arrays and objects accepted
+     * by the reader.
+     */
+    constexpr size_t MAX_DEPTH = 256;
+
+    /**
+     * @brief Type of a JSON value.
+     */
+    enum class ValueType {
+        Null,    ///< `null`
+        Boolean, ///< `true` or `false`
+        Number,  ///< Number
+        String,  ///< String
+        Array,   ///< Array
+        Object   ///< Object
+    };
+
+    /// Helpers used by the JSON reader and writer.
+    namespace detail {
+
+        inline bool is_whitespace(uint8_t c) {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        inline const uint8_t * skip_whitespace(const uint8_t * p, const uint8_t * end) {
+            while (p < end && is_whitespace(*p)) {
+                ++p;
+            }
+            return p;
+        }
+
+        /// `p` points to the opening quote. On success, `p` is moved past the closing quote.
+        inline edjx::error::JsonError skip_string(const uint8_t *& p, const uint8_t * end) {
+            const uint8_t * q = p + 1;
+            while (true) {
+                q = edjx::simd::find_first_of(q, end, '"', '\\');
+                if (q == end) {
+                    return edjx::error::JsonError::UnexpectedEnd;
+                }
+                if (*q == '"') {
+                    p = q + 1;
+                    return edjx::error::JsonError::Success;
+                }
+                if (end - q < 2) {
+                    return edjx::error::JsonError::UnexpectedEnd;
+                }
+                q += 2;
+            }
+        }
+
+        /// `p` points to `[` or `{`. On success, `p` is moved past the matching bracket.
+        inline edjx::error::JsonError skip_container(const uint8_t *& p, const uint8_t * end) {
+            uint8_t closers[MAX_DEPTH];
+            size_t depth = 0;
+            const uint8_t * q = p;
+            while (true) {
+                q = edjx::simd::find_first_of(q, end, '"', '[', ']', '{', '}');
+                if (q == end) {
+                    return edjx::error::JsonError::UnexpectedEnd;
+                }
+                switch (*q) {
+                    case '"': {
+                        edjx::error::JsonError err = skip_string(q, end);
+                        if (err != edjx::error::JsonError::Success) {
+                            return err;
+                        }
+                        continue;
+                    }
+                    case '[':
+                    case '{':
+                        if (depth == MAX_DEPTH) {
+                            return edjx::error::JsonError::SyntaxError;
+                        }
+                        closers[depth++] = (*q == '[') ? ']' : '}';
+                        break;
+                    default:
+                        if (depth == 0 || closers[depth - 1] != *q) {
+                            return edjx::error::JsonError::SyntaxError;
+                        }
+                        if (--depth == 0) {
+                            p = q + 1;
+                            return edjx::error::JsonError::Success;
+                        }
+                        break;
+                }
+                ++q;
+            }
+        }
+
+        inline bool is_number_char(uint8_t c) {
+            return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+        }
+
+        inline edjx::error::JsonError skip_literal(
+            const uint8_t *& p,
+            const uint8_t * end,
+            std::string_view literal
+        ) {
+            if (static_cast<size_t>(end - p) < literal.size()) {
+                return edjx::error::JsonError::UnexpectedEnd;
+            }
+            if (std::string_view(reinterpret_cast<const char *>(p), literal.size()) != literal) {
+                return edjx::error::JsonError::SyntaxError;
+            }
+            p += literal.size();
+            return edjx::error::JsonError::Success;
+        }
+
+        /// `p` points to the first byte of a value. On success, `p` is moved past the value.
+        inline edjx::error::JsonError skip_value(const uint8_t *& p, const uint8_t * end) {
+            if (p >= end) {
+                return edjx::error::JsonError::UnexpectedEnd;
+            }
+            switch (*p) {
+                case '"':
+                    return skip_string(p, end);
+                case '[':
+                case '{':
+                    return skip_container(p, end);
+                case 't':
+                    return skip_literal(p, end, "true");
+                case 'f':
+                    return skip_literal(p, end, "false");
+                case 'n':
+                    return skip_literal(p, end, "null");
+                default:
+                    if (*p != '-' && !(*p >= '0' && *p <= '9')) {
+                        return edjx::error::JsonError::SyntaxError;
+                    }
+                    while (p < end && is_number_char(*p)) {
+                        ++p;
+                    }
+                    return edjx::error::JsonError::Success;
+            }
+        }
+
+        inline int hex_digit(uint8_t c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        inline bool read_hex4(const uint8_t * p, const uint8_t * end, uint32_t & result) {
+            if (end - p < 4) {
+                return false;
+            }
+            result = 0;
+            for (int i = 0; i < 4; i++) {
+                int d = hex_digit(p[i]);
+                if (d < 0) {
+                    return false;
+                }
+                result = (result << 4) | static_cast<uint32_t>(d);
+            }
+            return true;
+        }
+
+        inline void append_utf8(std::string & out, uint32_t cp) {
+            if (cp < 0x80) {
+                out.push_back(static_cast<char>(cp));
+            } else if (cp < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            } else if (cp < 0x10000) {
+                out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            } else {
+                out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+        }
+
+    }
+
+    /**
+     * @brief Decodes the escape sequences of a raw JSON string.
+     *
+     * @param raw String contents between the quotes, as they appear
+     * in the document
+     * @param result Decoded string will be appended here
+     * @return Returns edjx::error::JsonError::Success on success,
+     * edjx::error::JsonError::InvalidEscape if an escape sequence is invalid.
+     */
+    inline edjx::error::JsonError unescape(std::string_view raw, std::string & result) {
+        const uint8_t * p = reinterpret_cast<const uint8_t *>(raw.data());
+        const uint8_t * end = p + raw.size();
+        result.reserve(result.size() + raw.size());
+        while (p < end) {
+            const uint8_t * q = edjx::simd::find_byte(p, end, '\\');
+            result.append(reinterpret_cast<const char *>(p), static_cast<size_t>(q - p));
+            if (q == end) {
+                break;
+            }
+            if (end - q < 2) {
+                return edjx::error::JsonError::InvalidEscape;
+            }
+            p = q + 2;
+            switch (q[1]) {
+                case '"': result.push_back('"'); break;
+                case '\\': result.push_back('\\'); break;
+                case '/': result.push_back('/'); break;
+                case 'b': result.push_back('\b'); break;
+                case 'f': result.push_back('\f'); break;
+                case 'n': result.push_back('\n'); break;
+                case 'r': result.push_back('\r'); break;
+                case 't': result.push_back('\t'); break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!detail::read_hex4(p, end, cp)) {
+                        return edjx::error::JsonError::InvalidEscape;
+                    }
+                    p += 4;
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        uint32_t low;
+                        if (end - p < 6 || p[0] != '\\' || p[1] != 'u'
+                                || !detail::read_hex4(p + 2, end, low)
+                                || low < 0xDC00 || low > 0xDFFF) {
+                            return edjx::error::JsonError::InvalidEscape;
+                        }
+                        p += 6;
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                        return edjx::error::JsonError::InvalidEscape;
+                    }
+                    detail::append_utf8(result, cp);
+                    break;
+                }
+                default:
+                    return edjx::error::JsonError::InvalidEscape;
+            }
+        }
+        return edjx::error::JsonError::Success;
+    }
+
+    class ArrayIterator;
+    class ObjectIterator;
+
+    /**
+     * @brief A lazily decoded JSON value.
+     *
+     * The value is a view into the document passed to edjx::json::parse().
+     * Nothing is decoded or allocated until one of the getters is called.
+     * A default-constructed value is empty, and all getters fail with
+     * edjx::error::JsonError::TypeMismatch.
+     */
+    class Value {
+    public:
+        /**
+         * @brief Constructs an empty value.
+         */
+        inline Value() : pos(nullptr), limit(nullptr) {}
+
+        /**
+         * @brief Constructs a value that starts at `pos` in a document
+         * ending at `limit`.
+         *
+         * @param pos First byte of the value
+         * @param limit End of the document
+         */
+        inline Value(const uint8_t * pos, const uint8_t * limit) : pos(pos), limit(limit) {}
+
+        /**
+         * @brief Check whether the value refers to a document.
+         *
+         * @return true The value is not empty
+         * @return false The value is empty
+         */
+        inline bool is_valid() const {
+            return pos != nullptr && pos < limit;
+        }
+
+        /**
+         * @brief Returns the type of the value.
+         *
+         * The type is determined from the first byte of the value,
+         * so this method is cheap. Empty values are reported as `null`.
+         *
+         * @return Type of the value
+         */
+        inline ValueType get_type() const {
+            if (!is_valid()) {
+                return ValueType::Null;
+            }
+            switch (*pos) {
+                case '"': return ValueType::String;
+                case '[': return ValueType::Array;
+                case '{': return ValueType::Object;
+                case 't':
+                case 'f': return ValueType::Boolean;
+                case 'n': return ValueType::Null;
+                default: return ValueType::Number;
+            }
+        }
+
+        /**
+         * @brief Check whether the value is `null`.
+         *
+         * @return true The value is `null`
+         * @return false The value is something else
+         */
+        inline bool is_null() const {
+            const uint8_t * p = pos;
+            return is_valid() && detail::skip_literal(p, limit, "null") == edjx::error::JsonError::Success;
+        }
+
+        /**
+         * @brief Reads a boolean value.
+         *
+         * @param result The value will be stored here
+         * @return Returns edjx::error::JsonError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::JsonError get_bool(bool & result) const {
+            if (!is_valid()) {
+                return edjx::error::JsonError::TypeMismatch;
+            }
+            const uint8_t * p = pos;
+            if (*p == 't') {
+                result = true;
+                return detail::skip_literal(p, limit, "true");
+            }
+            if (*p == 'f') {
+                result = false;
+                return detail::skip_literal(p, limit, "false");
+            }
+            return edjx::error::JsonError::TypeMismatch;
+        }
+
+        /**
+         * @brief Reads an integer value.
+         *
+         * @param result The value will be stored here
+         * @return Returns edjx::error::JsonError::Success on success,
+         * edjx::error::JsonError::NumberOutOfRange if the number does not fit
+         * into `int64_t`, or some other value on failure.
+         */
+        inline edjx::error::JsonError get_int64(int64_t & result) const {
+            bool negative = is_valid() && *pos == '-';
+            uint64_t magnitude;
+            edjx::error::JsonError err = parse_integer(negative ? pos + 1 : pos, magnitude);
+            if (err != edjx::error::JsonError::Success) {
+                return err;
+            }
+            uint64_t max = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+            if (magnitude > max + (negative ? 1 : 0)) {
+                return edjx::error::JsonError::NumberOutOfRange;
+            }
+            result = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+            return edjx::error::JsonError::Success;
+        }
+
+        /**
+         * @brief Reads a non-negative integer value.
+         *
+         * @param result The value will be stored here
+         * @return Returns edjx::error::JsonError::Success on success,
+         * edjx::error::JsonError::NumberOutOfRange if the number does not fit
+         * into `uint64_t`, or some other value on failure.
+         */
+        inline edjx::error::JsonError get_uint64(uint64_t & result) const {
+            if (is_valid() && *pos == '-') {
+                return edjx::error::JsonError::NumberOutOfRange;
+            }
+            return parse_integer(pos, result);
+        }
+
+        /**
+         * @brief Reads a floating-point value.
+         *
+         * @param result The value will be stored here
+         * @return Returns edjx::error::JsonError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::JsonError get_double(double & result) const {
+            if (get_type() != ValueType::Number) {
+                return edjx::error::JsonError::TypeMismatch;
+            }
+            const uint8_t * p = pos;
+            while (p < limit && detail::is_number_char(*p)) {
+                ++p;
+            }
+            // strtod() needs a terminated string; numbers are short, so
+            // a stack buffer covers every practical case.
+            char buffer[64];
+            std::string fallback;
+            const char * text = buffer;
+            size_t length = static_cast<size_t>(p - pos);
+            if (length < sizeof(buffer)) {
+                std::memcpy(buffer, pos, length);
+                buffer[length] = '\0';
+            } else {
+                fallback.assign(reinterpret_cast<const char *>(pos), length);
+                text = fallback.c_str();
+            }
+            char * parsed_end;
+            result = std::strtod(text, &parsed_end);
+            if (parsed_end != text + length) {
+                return edjx::error::JsonError::SyntaxError;
+            }
+            if (std::isinf(result)) {
+                return edjx::error::JsonError::NumberOutOfRange;
+            }
+            return edjx::error::JsonError::Success;
+        }
+
+        /**
+         * @brief Returns the contents of a string value without decoding
+         * escape sequences.
+         *
+         * This method does not copy. Use it when the string is known not to
+         * contain escapes (e.g., identifiers), or pass the result to
+         * edjx::json::unescape().
+         *
+         * @param result View of the string contents between the quotes
+         * @return Returns edjx::error::JsonError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::JsonError get_raw_string(std::string_view & result) const {
+            if (get_type() != ValueType::String) {
+                return edjx::error::JsonError::TypeMismatch;
+            }
+            const uint8_t * p = pos;
+            edjx::error::JsonError err = detail::skip_string(p, limit);
+            if (err != edjx::error::JsonError::Success) {
+                return err;
+            }
+            result = std::string_view(reinterpret_cast<const char *>(pos + 1), static_cast<size_t>(p - pos - 2));
+            return edjx::error::JsonError::Success;
+        }
+
+        /**
+         * @brief Reads a string value and decodes its escape sequences.
+         *
+         * @param result The decoded string will be stored here
+         * @return Returns edjx::error::JsonError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::JsonError get_string(std::string & result) const {
+            std::string_view raw;
+            edjx::error::JsonError err = get_raw_string(raw);
+            if (err != edjx::error::JsonError::Success) {
+                return err;
+            }
+            result.clear();
+            return unescape(raw, result);
+        }
+
+        /**
+         * @brief Returns the JSON text of the value.
+         *
+         * This method does not copy. It is useful for forwarding
+         * a part of a document without re-encoding it.
+         *
+         * @param result View of the value as it appears in the document
+         * @return Returns edjx::error::JsonError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::JsonError get_raw_json(std::string_view & result) const {
+            if (!is_valid()) {
+                return edjx::error::JsonError::TypeMismatch;
+            }
+            const uint8_t * p = pos;
+            edjx::error::JsonError err = detail::skip_value(p, limit);
+            if (err != edjx::error::JsonError::Success) {
+                return err;
+            }
+            result = std::string_view(reinterpret_cast<const char *>(pos), static_cast<size_t>(p - pos));
+            return edjx::error::JsonError::Success;
+        }
+
+        /**
+         * @brief Starts iterating over the elements of an array value.
+         *
+         * @param result Iterator positioned before the first element
+         * @return Returns edjx::error::JsonError::Success on success,
+         * edjx::error::JsonError::TypeMismatch if the value is not an array.
+         */
+        inline edjx::error::JsonError get_array(ArrayIterator & result) const;
+
+        /**
+         * @brief Starts iterating over the fields of an object value.
+         *
+         * @param result Iterator positioned before the first field
+         * @return Returns edjx::error::JsonError::Success on success,
+         * edjx::error::JsonError::TypeMismatch if the value is not an object.
+         */
+        inline edjx::error::JsonError get_object(ObjectIterator & result) const;
+
+        /**
+         * @brief Looks up a field of an object value.
+         *
+         * Fields that precede the requested one are skipped without
+         * being decoded.
+         *
+         * @param name Field name (without escape sequences)
+         * @param result The field value will be stored here
+         * @return Returns edjx::error::JsonError::Success on success,
+         * edjx::error::JsonError::FieldNotFound if the object has no such field,
+         * or some other value on failure.
+         */
+        inline edjx::error::JsonError get_field(std::string_view name, Value & result) const;
+
+        /**
+         * @brief Looks up an element of an array value.
+         *
+         * @param index Zero-based element index
+         * @param result The element will be stored here
+         * @return Returns edjx::error::JsonError::Success on success,
+         * edjx::error::JsonError::IndexOutOfRange if the array is too short,
+         * or some other value on failure.
+         */
+        inline edjx::error::JsonError get_element(size_t index, Value & result) const;
+
+    private:
+        inline edjx::error::JsonError parse_integer(const uint8_t * p, uint64_t & result) const {
+            if (get_type() != ValueType::Number) {
+                return edjx::error::JsonError::TypeMismatch;
+            }
+            if (p >= limit || *p < '0' || *p > '9') {
+                return edjx::error::JsonError::SyntaxError;
+            }
+            uint64_t value = 0;
+            for (; p < limit && *p >= '0' && *p <= '9'; ++p) {
+                uint64_t digit = static_cast<uint64_t>(*p - '0');
+                if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+                    return edjx::error::JsonError::NumberOutOfRange;
+                }
+                value = value * 10 + digit;
+            }
+            if (p < limit && detail::is_number_char(*p)) {
+                // Fractions and exponents are not integers.
+                return edjx::error::JsonError::TypeMismatch;
+            }
+            result = value;
+            return edjx::error::JsonError::Success;
+        }
+
+        /// First byte of the value
+        const uint8_t * pos;
+        /// End of the document
+        const uint8_t * limit;
+    };
+
+    /**
+     * @brief Iterator over the elements of a JSON array.
+     */
+    class ArrayIterator {
+    public:
+        /**
+         * @brief Constructs an iterator over an empty array.
+         */
+        inline ArrayIterator() : pos(nullptr), limit(nullptr), first(true) {}
+
+        /**
+         * @brief Constructs an iterator over the array that starts at `pos`.
+         *
+         * @param pos Position of the opening bracket
+         * @param limit End of the document
+         */
+        inline ArrayIterator(const uint8_t * pos, const uint8_t * limit)
+            : pos(pos + 1), limit(limit), first(true) {}
+
+        /**
+         * @brief Advances to the next element.
+         *
+         * @param result The next element will be stored here
+         * @return Returns edjx::error::JsonError::Success on success,
+         * edjx::error::JsonError::EndOfContainer after the last element,
+         * or some other value on failure.
+         */
+        inline edjx::error::JsonError next(Value & result) {
+            if (pos == nullptr) {
+                return edjx::error::JsonError::EndOfContainer;
+            }
+            pos = detail::skip_whitespace(pos, limit);
+            if (pos == limit) {
+                return edjx::error::JsonError::UnexpectedEnd;
+            }
+            if (*pos == ']') {
+                pos = nullptr;
+                return edjx::error::JsonError::EndOfContainer;
+            }
+            if (!first) {
+                if (*pos != ',') {
+                    return edjx::error::JsonError::SyntaxError;
+                }
+                pos = detail::skip_whitespace(pos + 1, limit);
+            }
+            first = false;
+            const uint8_t * start = pos;
+            edjx::error::JsonError err = detail::skip_value(pos, limit);
+            if (err != edjx::error::JsonError::Success) {
+                return err;
+            }
+            result = Value(start, limit);
+            return edjx::error::JsonError::Success;
+        }
+
+    private:
+        const uint8_t * pos;
+        const uint8_t * limit;
+        bool first;
+    };
+
+    /**
+     * @brief Iterator over the fields of a JSON object.
+     */
+    class ObjectIterator {
+    public:
+        /**
+         * @brief Constructs an iterator over an empty object.
+         */
+        inline ObjectIterator() : pos(nullptr), limit(nullptr), first(true) {}
+
+        /**
+         * @brief Constructs an iterator over the object that starts at `pos`.
+         *
+         * @param pos Position of the opening brace
+         * @param limit End of the document
+         */
+        inline ObjectIterator(const uint8_t * pos, const uint8_t * limit)
+            : pos(pos + 1), limit(limit), first(true) {}
+
+        /**
+         * @brief Advances to the next field.
+         *
+         * @param raw_key Field name as it appears in the document
+         * (escape sequences are not decoded, see edjx::json::unescape())
+         * @param result Field value will be stored here
+         * @return Returns edjx::error::JsonError::Success on success,
+         * edjx::error::JsonError::EndOfContainer after the last field,
+         * or some other value on failure.
+         */
+        inline edjx::error::JsonError next(std::string_view & raw_key, Value & result) {
+            if (pos == nullptr) {
+                return edjx::error::JsonError::EndOfContainer;
+            }
+            pos = detail::skip_whitespace(pos, limit);
+            if (pos == limit) {
+                return edjx::error::JsonError::UnexpectedEnd;
+            }
+            if (*pos == '}') {
+                pos = nullptr;
+                return edjx::error::JsonError::EndOfContainer;
+            }
+            if (!first) {
+                if (*pos != ',') {
+                    return edjx::error::JsonError::SyntaxError;
+                }
+                pos = detail::skip_whitespace(pos + 1, limit);
+            }
+            first = false;
+            if (pos == limit || *pos != '"') {
+                return edjx::error::JsonError::SyntaxError;
+            }
+            const uint8_t * key_start = pos;
+            edjx::error::JsonError err = detail::skip_string(pos, limit);
+            if (err != edjx::error::JsonError::Success) {
+                return err;
+            }
+            raw_key = std::string_view(
+                reinterpret_cast<const char *>(key_start + 1),
+                static_cast<size_t>(pos - key_start - 2)
+            );
+            pos = detail::skip_whitespace(pos, limit);
+            if (pos == limit || *pos != ':') {
+                return edjx::error::JsonError::SyntaxError;
+            }
+            pos = detail::skip_whitespace(pos + 1, limit);
+            const uint8_t * start = pos;
+            err = detail::skip_value(pos, limit);
+            if (err != edjx::error::JsonError::Success) {
+                return err;
+            }
+            result = Value(start, limit);
+            return edjx::error::JsonError::Success;
+        }
+
+    private:
+        const uint8_t * pos;
+        const uint8_t * limit;
+        bool first;
+    };
+
+    inline edjx::error::JsonError Value::get_array(ArrayIterator & result) const {
+        if (get_type() != ValueType::Array) {
+            return edjx::error::JsonError::TypeMismatch;
+        }
+        result = ArrayIterator(pos, limit);
+        return edjx::error::JsonError::Success;
+    }
+
+    inline edjx::error::JsonError Value::get_object(ObjectIterator & result) const {
+        if (get_type() != ValueType::Object) {
+            return edjx::error::JsonError::TypeMismatch;
+        }
+        result = ObjectIterator(pos, limit);
+        return edjx::error::JsonError::Success;
+    }
+
+    inline edjx::error::JsonError Value::get_field(std::string_view name, Value & result) const {
+        ObjectIterator it;
+        edjx::error::JsonError err = get_object(it);
+        if (err != edjx::error::JsonError::Success) {
+            return err;
+        }
+        std::string_view key;
+        Value value;
+        std::string decoded;
+        while ((err = it.next(key, value)) == edjx::error::JsonError::Success) {
+            if (key.find('\\') == std::string_view::npos) {
+                if (key == name) {
+                    result = value;
+                    return edjx::error::JsonError::Success;
+                }
+            } else {
+                decoded.clear();
+                if (unescape(key, decoded) == edjx::error::JsonError::Success && decoded == name) {
+                    result = value;
+                    return edjx::error::JsonError::Success;
+                }
+            }
+        }
+        return err == edjx::error::JsonError::EndOfContainer
+            ? edjx::error::JsonError::FieldNotFound
+            : err;
+    }
+
+    inline edjx::error::JsonError Value::get_element(size_t index, Value & result) const {
+        ArrayIterator it;
+        edjx::error::JsonError err = get_array(it);
+        if (err != edjx::error::JsonError::Success) {
+            return err;
+        }
+        Value value;
+        for (size_t i = 0; (err = it.next(value)) == edjx::error::JsonError::Success; i++) {
+            if (i == index) {
+                result = value;
+                return edjx::error::JsonError::Success;
+            }
+        }
+        return err == edjx::error::JsonError::EndOfContainer
+            ? edjx::error::JsonError::IndexOutOfRange
+            : err;
+    }
+
+    /**
+     * @brief Parses a JSON document on demand.
+     *
+     * Only the structure of the document is checked (strings, brackets
+     * and braces); scalar values are validated when they are read.
+     * The document is not copied, so `data` must outlive `result`
+     * and all values obtained from it.
+     *
+     * @param result The root value will be stored here
+     * @param data Pointer to the document bytes
+     * @param size Number of bytes in the document
+     * @return Returns edjx::error::JsonError::Success on success,
+     * some other value on failure.
+     */
+    inline edjx::error::JsonError parse(Value & result, const uint8_t * data, size_t size) {
+        const uint8_t * end = data + size;
+        const uint8_t * start = detail::skip_whitespace(data, end);
+        const uint8_t * p = start;
+        edjx::error::JsonError err = detail::skip_value(p, end);
+        if (err != edjx::error::JsonError::Success) {
+            return err;
+        }
+        if (detail::skip_whitespace(p, end) != end) {
+            return edjx::error::JsonError::SyntaxError;
+        }
+        result = Value(start, end);
+        return edjx::error::JsonError::Success;
+    }
+
+    /**
+     * @brief Parses a JSON document on demand (e.g., a body returned
+     * by `read_body()`).
+     *
+     * @param result The root value will be stored here
+     * @param bytes Document bytes
+     * @return Returns edjx::error::JsonError::Success on success,
+     * some other value on failure.
+     */
+    inline edjx::error::JsonError parse(Value & result, const std::vector<uint8_t> & bytes) {
+        return parse(result, bytes.data(), bytes.size());
+    }
+
+    /**
+     * @brief Parses a JSON document on demand.
+     *
+     * @param result The root value will be stored here
+     * @param text Document text
+     * @return Returns edjx::error::JsonError::Success on success,
+     * some other value on failure.
+     */
+    inline edjx::error::JsonError parse(Value & result, std::string_view text) {
+        return parse(result, reinterpret_cast<const uint8_t *>(text.data()), text.size());
+    }
+
+    /**
+     * @brief Streaming JSON writer.
+     *
+     * Commas and quoting are handled by the writer. When constructed with
+     * a write stream, the buffered output is written to the stream every
+     * time it grows past the flush threshold, so the memory used does not
+     * depend on the size of the document.
+     *
+     * ```
+     * edjx::json::Writer writer(write_stream);
+     * writer.begin_object()
+     *     .key("name").value(name)
+     *     .key("size").value(size)
+     *     .end_object();
+     * writer.flush();
+     * ```
+     */
+    class Writer {
+    public:
+        /// Default flush threshold in bytes
+        static constexpr size_t DEFAULT_FLUSH_THRESHOLD = 16 * 1024;
+
+        /**
+         * @brief Constructs a writer that keeps the output in memory.
+         */
+        inline Writer()
+            : write_stream(nullptr),
+            flush_threshold(0),
+            need_comma(false),
+            stream_status(edjx::error::StreamError::Success) {}
+
+        /**
+         * @brief Constructs a writer that flushes the output into a write stream.
+         *
+         * @param write_stream Stream that receives the output
+         * @param flush_threshold Buffer size that triggers a flush
+         */
+        inline explicit Writer(
+            edjx::stream::WriteStream & write_stream,
+            size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD
+        ) : write_stream(&write_stream),
+            flush_threshold(flush_threshold),
+            need_comma(false),
+            stream_status(edjx::error::StreamError::Success) {
+            buffer.reserve(flush_threshold);
+        }
+
+        /**
+         * @brief Starts an object.
+         *
+         * @return Reference to this Writer object
+         */
+        inline Writer & begin_object() {
+            before_value();
+            buffer.push_back('{');
+            need_comma = false;
+            return *this;
+        }
+
+        /**
+         * @brief Ends the current object.
+         *
+         * @return Reference to this Writer object
+         */
+        inline Writer & end_object() {
+            buffer.push_back('}');
+            return after_value();
+        }
+
+        /**
+         * @brief Starts an array.
+         *
+         * @return Reference to this Writer object
+         */
+        inline Writer & begin_array() {
+            before_value();
+            buffer.push_back('[');
+            need_comma = false;
+            return *this;
+        }
+
+        /**
+         * @brief Ends the current array.
+         *
+         * @return Reference to this Writer object
+         */
+        inline Writer & end_array() {
+            buffer.push_back(']');
+            return after_value();
+        }
+
+        /**
+         * @brief Writes an object field name. Must be followed by a value.
+         *
+         * @param name Field name
+         * @return Reference to this Writer object
+         */
+        inline Writer & key(std::string_view name) {
+            before_value();
+            append_string(name);
+            buffer.push_back(':');
+            need_comma = false;
+            return *this;
+        }
+
+        /**
+         * @brief Writes a string value.
+         *
+         * @param text String value
+         * @return Reference to this Writer object
+         */
+        inline Writer & value(std::string_view text) {
+            before_value();
+            append_string(text);
+            return after_value();
+        }
+
+        /**
+         * @brief Writes a string value.
+         *
+         * @param text String value
+         * @return Reference to this Writer object
+         */
+        inline Writer & value(const char * text) {
+            return value(std::string_view(text));
+        }
+
+        /**
+         * @brief Writes a string value.
+         *
+         * @param text String value
+         * @return Reference to this Writer object
+         */
+        inline Writer & value(const std::string & text) {
+            return value(std::string_view(text));
+        }
+
+        /**
+         * @brief Writes a boolean value.
+         *
+         * @param b Boolean value
+         * @return Reference to this Writer object
+         */
+        inline Writer & value(bool b) {
+            before_value();
+            buffer.append(b ? "true" : "false");
+            return after_value();
+        }
+
+        /**
+         * @brief Writes an integer value.
+         *
+         * @param number Integer value
+         * @return Reference to this Writer object
+         */
+        template <typename T, typename std::enable_if<
+            std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+        inline Writer & value(T number) {
+            before_value();
+            if (std::is_signed<T>::value && number < 0) {
+                buffer.push_back('-');
+                append_unsigned(0 - static_cast<uint64_t>(number));
+            } else {
+                append_unsigned(static_cast<uint64_t>(number));
+            }
+            return after_value();
+        }
+
+        /**
+         * @brief Writes a floating-point value.
+         *
+         * NaN and infinite values cannot be represented in JSON
+         * and are written as `null`.
+         *
+         * @param number Floating-point value
+         * @return Reference to this Writer object
+         */
+        inline Writer & value(double number) {
+            before_value();
+            if (std::isfinite(number)) {
+                char text[32];
+                int length = std::snprintf(text, sizeof(text), "%.17g", number);
+                buffer.append(text, static_cast<size_t>(length));
+            } else {
+                buffer.append("null");
+            }
+            return after_value();
+        }
+
+        /**
+         * @brief Writes a `null` value.
+         *
+         * @return Reference to this Writer object
+         */
+        inline Writer & null() {
+            before_value();
+            buffer.append("null");
+            return after_value();
+        }
+
+        /**
+         * @brief Writes already encoded JSON text as a value.
+         *
+         * @param json Valid JSON text
+         * @return Reference to this Writer object
+         */
+        inline Writer & raw(std::string_view json) {
+            before_value();
+            buffer.append(json.data(), json.size());
+            return after_value();
+        }
+
+        /**
+         * @brief Returns the buffered output that has not been flushed yet.
+         *
+         * @return Buffered JSON text
+         */
+        inline const std::string & get_buffer() const {
+            return buffer;
+        }
+
+        /**
+         * @brief Discards the buffered output and resets the writer so it
+         * can encode another document. The buffer capacity is kept.
+         */
+        inline void clear() {
+            buffer.clear();
+            need_comma = false;
+        }
+
+        /**
+         * @brief Writes the buffered output into the write stream.
+         *
+         * Does nothing when the writer has no write stream.
+         *
+         * Once a write has failed, the stream is not written to again
+         * and buffered output is discarded, so a writer whose client has
+         * gone away does not keep growing its buffer.
+         *
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure (including failures of earlier
+         * automatic flushes).
+         */
+        inline edjx::error::StreamError flush() {
+            if (write_stream == nullptr) {
+                return stream_status;
+            }
+            if (stream_status == edjx::error::StreamError::Success && !buffer.empty()) {
+                stream_status = write_stream->write_chunk(buffer);
+            }
+            buffer.clear();
+            return stream_status;
+        }
+
+    private:
+        inline void before_value() {
+            if (need_comma) {
+                buffer.push_back(',');
+            }
+        }
+
+        inline Writer & after_value() {
+            need_comma = true;
+            if (write_stream != nullptr && buffer.size() >= flush_threshold) {
+                flush();
+            }
+            return *this;
+        }
+
+        inline void append_unsigned(uint64_t number) {
+            char digits[20];
+            size_t n = 0;
+            do {
+                digits[n++] = static_cast<char>('0' + number % 10);
+                number /= 10;
+            } while (number != 0);
+            while (n > 0) {
+                buffer.push_back(digits[--n]);
+            }
+        }
+
+        inline void append_string(std::string_view text) {
+            static const char hex[] = "0123456789abcdef";
+            buffer.push_back('"');
+            size_t run = 0;
+            for (size_t i = 0; i < text.size(); i++) {
+                uint8_t c = static_cast<uint8_t>(text[i]);
+                if (c >= 0x20 && c != '"' && c != '\\') {
+                    continue;
+                }
+                buffer.append(text.data() + run, i - run);
+                run = i + 1;
+                buffer.push_back('\\');
+                switch (c) {
+                    case '"': buffer.push_back('"'); break;
+                    case '\\': buffer.push_back('\\'); break;
+                    case '\b': buffer.push_back('b'); break;
+                    case '\f': buffer.push_back('f'); break;
+                    case '\n': buffer.push_back('n'); break;
+                    case '\r': buffer.push_back('r'); break;
+                    case '\t': buffer.push_back('t'); break;
+                    default:
+                        buffer.append("u00");
+                        buffer.push_back(hex[c >> 4]);
+                        buffer.push_back(hex[c & 0xF]);
+                        break;
+                }
+            }
+            buffer.append(text.data() + run, text.size() - run);
+            buffer.push_back('"');
+        }
+
+        std::string buffer;
+        edjx::stream::WriteStream * write_stream;
+        size_t flush_threshold;
+        bool need_comma;
+        edjx::error::StreamError stream_status;
+    };
+
+}}
@@ -2,9 +2,13 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "error.hpp"
+#include "expected.hpp"
+#include "host.hpp"
+#include "stream.hpp"
 
 namespace edjx {
 
@@ -89,4 +93,218 @@ namespace kv {
      */
     edjx::error::KVError remove(const std::string & key);
 
-}}
\ No newline at end of file
+    /**
+     * @brief Returns the value associated with the provided key.
+     * 
+     * @param key Key
+     * @return The value, or the error on failure
+     */
+    inline Expected<std::vector<uint8_t>, edjx::error::KVError> get(const std::string & key) {
+        std::vector<uint8_t> result;
+        edjx::error::KVError err = get(result, key);
+        if (err != edjx::error::KVError::Success) {
+            return err;
+        }
+        return result;
+    }
+
+    /**
+     * @brief A value in the KV store read incrementally.
+     * 
+     * The value is copied out of the host in pieces, so a large value can
+     * be sent to the client (see pipe_to()) without holding all of it in
+     * the memory of the function. The host resources of the value are
+     * released when the object is destroyed.
+     */
+    class ValueStream {
+    public:
+        /// Default number of bytes copied by one pipe_to() step
+        static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+        /**
+         * @brief Constructs an empty value stream.
+         */
+        inline ValueStream() : sd(0), initialized(false), total(0), left(0) {}
+
+        /**
+         * @brief Constructs a value stream for a host stream descriptor.
+         * 
+         * @param sd Stream descriptor returned by the host
+         */
+        inline explicit ValueStream(uint32_t sd)
+            : sd(sd),
+            initialized(true),
+            total(edjx::stream::stream_size(sd)),
+            left(total) {}
+
+        inline ValueStream(ValueStream && other)
+            : sd(other.sd),
+            initialized(other.initialized),
+            total(other.total),
+            left(other.left) {
+            other.initialized = false;
+        }
+
+        inline ValueStream & operator=(ValueStream && other) {
+            if (this != &other) {
+                close();
+                sd = other.sd;
+                initialized = other.initialized;
+                total = other.total;
+                left = other.left;
+                other.initialized = false;
+            }
+            return *this;
+        }
+
+        ValueStream(const ValueStream &) = delete;
+        ValueStream & operator=(const ValueStream &) = delete;
+
+        inline ~ValueStream() {
+            close();
+        }
+
+        /**
+         * @brief Returns the size of the value in bytes.
+         * 
+         * @return Size of the value
+         */
+        inline size_t size() const {
+            return total;
+        }
+
+        /**
+         * @brief Returns the number of bytes that have not been read yet.
+         * 
+         * @return Number of remaining bytes
+         */
+        inline size_t remaining() const {
+            return left;
+        }
+
+        /**
+         * @brief Reads up to `size` bytes of the value.
+         * 
+         * @param result Destination
+         * @param size Number of bytes to read
+         * @param bytes_read Number of bytes stored in `result`
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream if the whole value was read,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError read(uint8_t * result, size_t size, size_t & bytes_read) {
+            bytes_read = 0;
+            if (!initialized) {
+                return edjx::error::StreamError::StreamClosed;
+            }
+            if (left == 0) {
+                return edjx::error::StreamError::EndOfStream;
+            }
+            if (size > left) {
+                size = left;
+            }
+            bytes_read = edjx::stream::stream_read_n(sd, result, static_cast<uint32_t>(size));
+            if (bytes_read == 0) {
+                left = 0;
+                return edjx::error::StreamError::EndOfStream;
+            }
+            left -= bytes_read;
+            return edjx::error::StreamError::Success;
+        }
+
+        /**
+         * @brief Reads the rest of the value.
+         * 
+         * @param result Remaining bytes of the value
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError read_all(std::vector<uint8_t> & result) {
+            result.resize(left);
+            size_t bytes_read = 0;
+            edjx::error::StreamError err = left == 0
+                ? edjx::error::StreamError::Success
+                : read(result.data(), result.size(), bytes_read);
+            result.resize(bytes_read);
+            return err == edjx::error::StreamError::EndOfStream ? edjx::error::StreamError::Success : err;
+        }
+
+        /**
+         * @brief Writes the rest of the value into a write stream
+         * in chunks of at most `chunk_size` bytes.
+         * 
+         * After all data is transmitted, both streams are closed. On
+         * failure, `write_stream` is aborted so a truncated value is
+         * not sent as if it were complete.
+         * 
+         * @param write_stream Write stream to which the value will be sent
+         * @param chunk_size Size of the chunks (and of the only buffer used)
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError pipe_to(
+            edjx::stream::WriteStream & write_stream,
+            size_t chunk_size = DEFAULT_CHUNK_SIZE
+        ) {
+            std::vector<uint8_t> buffer(left < chunk_size ? left : chunk_size);
+            while (true) {
+                size_t bytes_read = 0;
+                edjx::error::StreamError err = read(buffer.data(), buffer.size(), bytes_read);
+                if (err == edjx::error::StreamError::EndOfStream) {
+                    break;
+                }
+                if (err == edjx::error::StreamError::Success) {
+                    err = write_stream.write_chunk(buffer.data(), bytes_read);
+                }
+                if (err != edjx::error::StreamError::Success) {
+                    close();
+                    write_stream.abort();
+                    return err;
+                }
+            }
+            close();
+            return write_stream.close();
+        }
+
+        /**
+         * @brief Releases the value. Further reads fail.
+         */
+        inline void close() {
+            if (initialized) {
+                edjx::stream::stream_drop(sd);
+                initialized = false;
+                left = 0;
+            }
+        }
+
+    private:
+        uint32_t sd;
+        bool initialized;
+        size_t total;
+        size_t left;
+    };
+
+    /**
+     * @brief Opens the value associated with the provided key for
+     * incremental reading.
+     * 
+     * Unlike get(), the value is not copied into the memory of the
+     * function up front.
+     * 
+     * @param result Value stream
+     * @param key Key
+     * @return Returns edjx::error::KVError::Success on success,
+     * some other value on failure
+     */
+    inline edjx::error::KVError get_stream(ValueStream & result, const std::string & key) {
+        uint32_t sd = 0;
+        int32_t error_code = 0;
+        if (host_kv_get(reinterpret_cast<const uint8_t *>(key.data()),
+                static_cast<uint32_t>(key.size()), &sd, &error_code) < 0) {
+            return edjx::host::to_kv_error(error_code);
+        }
+        result = ValueStream(sd);
+        return edjx::error::KVError::Success;
+    }
+
+}}
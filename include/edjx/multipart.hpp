@@ -0,0 +1,439 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <strings.h>
+
+#include "error.hpp"
+#include "http.hpp"
+#include "simd.hpp"
+#include "stream.hpp"
+
+namespace edjx {
+
+/**
+ * @brief Incremental multipart/form-data parser (RFC 7578).
+ *
+ * edjx::multipart::MultipartReader reads a request body from a stream one
+ * part at a time, and passes the bytes of each part to a write stream as
+ * they arrive (e.g., a stream from edjx::storage::put_streaming()). Only
+ * the read-ahead of the underlying edjx::stream::BufferedReadStream and
+ * the headers of the current part are held in memory.
+ *
+ * ```
+ * edjx::stream::ReadStream body;
+ * request.open_read_stream(body);
+ * edjx::stream::BufferedReadStream buffered(body);
+ * edjx::multipart::MultipartReader reader(buffered, boundary);
+ * edjx::multipart::Part part;
+ * while (reader.next_part(part) == edjx::error::StreamError::Success) {
+ *     edjx::storage::StorageResponsePending pending;
+ *     edjx::stream::WriteStream upload;
+ *     edjx::storage::put_streaming(pending, upload, bucket, part.filename, "");
+ *     reader.read_part(upload);
+ *     upload.close();
+ *     // ...
+ * }
+ * ```
+ */
+namespace multipart {
+
+    /// Default limit on the size of the headers of one part in bytes
+    constexpr size_t DEFAULT_MAX_HEADER_SIZE = 16 * 1024;
+
+    /**
+     * @brief Headers of one part of a multipart body.
+     */
+    struct Part {
+        /// All headers of the part
+        edjx::http::HttpHeaders headers;
+        /// Form field name (`name` of Content-Disposition)
+        std::string name;
+        /// File name (`filename` of Content-Disposition), empty if missing
+        std::string filename;
+        /// Content type of the part, empty if missing
+        std::string content_type;
+    };
+
+    /**
+     * @brief Extracts the boundary from a multipart Content-Type value.
+     *
+     * @param content_type Value of the Content-Type header
+     * @param boundary The boundary
+     * @return true The boundary was found
+     * @return false The value has no boundary parameter
+     */
+    inline bool get_boundary(const std::string & content_type, std::string & boundary) {
+        size_t position = 0;
+        while ((position = content_type.find(';', position)) != std::string::npos) {
+            position++;
+            while (position < content_type.size()
+                    && (content_type[position] == ' ' || content_type[position] == '\t')) {
+                position++;
+            }
+            if (strncasecmp(content_type.c_str() + position, "boundary=", 9) != 0) {
+                continue;
+            }
+            position += 9;
+            if (position < content_type.size() && content_type[position] == '"') {
+                size_t end = content_type.find('"', position + 1);
+                if (end == std::string::npos) {
+                    return false;
+                }
+                boundary = content_type.substr(position + 1, end - position - 1);
+            } else {
+                size_t end = content_type.find_first_of("; \t", position);
+                boundary = content_type.substr(position, end == std::string::npos ? end : end - position);
+            }
+            return !boundary.empty();
+        }
+        return false;
+    }
+
+    namespace detail {
+
+        /// Returns a parameter of a header value like `form-data; name="a"`.
+        inline std::string get_parameter(const std::string & value, const char * name) {
+            size_t name_size = std::strlen(name);
+            size_t position = 0;
+            while ((position = value.find(';', position)) != std::string::npos) {
+                position++;
+                while (position < value.size() && (value[position] == ' ' || value[position] == '\t')) {
+                    position++;
+                }
+                if (strncasecmp(value.c_str() + position, name, name_size) != 0
+                        || position + name_size >= value.size()
+                        || value[position + name_size] != '=') {
+                    continue;
+                }
+                position += name_size + 1;
+                if (position < value.size() && value[position] == '"') {
+                    std::string result;
+                    for (position++; position < value.size() && value[position] != '"'; position++) {
+                        if (value[position] == '\\' && position + 1 < value.size()) {
+                            position++;
+                        }
+                        result.push_back(value[position]);
+                    }
+                    return result;
+                }
+                size_t end = value.find_first_of("; \t", position);
+                return value.substr(position, end == std::string::npos ? end : end - position);
+            }
+            return std::string();
+        }
+
+    }
+
+    /**
+     * @brief Reads the parts of a multipart body from a stream.
+     *
+     * Errors are reported as edjx::error::StreamError values;
+     * a malformed body is reported as edjx::error::StreamError::Unknown.
+     */
+    class MultipartReader {
+    public:
+        /**
+         * @brief Constructs a reader for a multipart body.
+         *
+         * @param stream Buffered stream with the body
+         * @param boundary Boundary from the Content-Type header
+         * (see get_boundary())
+         * @param max_header_size Largest accepted size of the headers
+         * of one part
+         */
+        inline MultipartReader(
+            edjx::stream::BufferedReadStream & stream,
+            const std::string & boundary,
+            size_t max_header_size = DEFAULT_MAX_HEADER_SIZE
+        ) : stream(stream),
+            delimiter("\r\n--" + boundary),
+            max_header_size(max_header_size),
+            state(State::Preamble) {}
+
+        /**
+         * @brief Advances to the next part and reads its headers.
+         *
+         * If the body of the current part was not read, it is skipped.
+         *
+         * @param part Headers of the part
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream after the last part,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError next_part(Part & part) {
+            edjx::error::StreamError err = edjx::error::StreamError::Success;
+            if (state == State::Preamble) {
+                err = skip_preamble();
+            } else if (state == State::Body) {
+                err = skip_part();
+            }
+            if (err != edjx::error::StreamError::Success) {
+                return err;
+            }
+            if (state == State::Done) {
+                return edjx::error::StreamError::EndOfStream;
+            }
+            err = read_boundary_end();
+            if (err != edjx::error::StreamError::Success) {
+                return err;
+            }
+            if (state == State::Done) {
+                return edjx::error::StreamError::EndOfStream;
+            }
+            err = read_headers(part);
+            if (err == edjx::error::StreamError::Success) {
+                state = State::Body;
+            }
+            return err;
+        }
+
+        /**
+         * @brief Writes the body of the current part into a write stream.
+         *
+         * The write stream is not closed.
+         *
+         * @param write_stream Destination of the part body
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError read_part(edjx::stream::WriteStream & write_stream) {
+            return read_body([&write_stream](const uint8_t * data, size_t size) {
+                return write_stream.write_chunk(data, size);
+            });
+        }
+
+        /**
+         * @brief Reads the body of the current part into memory.
+         *
+         * @param result Body of the part
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError read_part(std::vector<uint8_t> & result) {
+            result.clear();
+            return read_body([&result](const uint8_t * data, size_t size) {
+                result.insert(result.end(), data, data + size);
+                return edjx::error::StreamError::Success;
+            });
+        }
+
+        /**
+         * @brief Skips the body of the current part.
+         *
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError skip_part() {
+            return read_body([](const uint8_t *, size_t) {
+                return edjx::error::StreamError::Success;
+            });
+        }
+
+    private:
+        enum class State {
+            Preamble,
+            Boundary,
+            Body,
+            Done
+        };
+
+        /// Finds `\r\n--boundary` in the buffered data, starting at `from`.
+        inline const uint8_t * find_delimiter(const uint8_t * from, const uint8_t * end) const {
+            const uint8_t * first = reinterpret_cast<const uint8_t *>(delimiter.data());
+            size_t size = delimiter.size();
+            while (static_cast<size_t>(end - from) >= size) {
+                const uint8_t * hit = simd::find_first_of(from, end - size + 1, '\r');
+                if (hit == end - size + 1) {
+                    return end;
+                }
+                if (std::memcmp(hit, first, size) == 0) {
+                    return hit;
+                }
+                from = hit + 1;
+            }
+            return end;
+        }
+
+        template <typename Sink>
+        inline edjx::error::StreamError read_body(Sink sink) {
+            if (state != State::Body) {
+                return edjx::error::StreamError::Success;
+            }
+            while (true) {
+                const uint8_t * begin = stream.data();
+                const uint8_t * end = begin + stream.available();
+                const uint8_t * hit = find_delimiter(begin, end);
+                if (hit != end) {
+                    edjx::error::StreamError err = emit(sink, begin, hit - begin);
+                    if (err != edjx::error::StreamError::Success) {
+                        return err;
+                    }
+                    stream.consume(delimiter.size());
+                    state = State::Boundary;
+                    return edjx::error::StreamError::Success;
+                }
+                // Bytes that cannot be the start of a delimiter are passed on
+                // right away, so the buffer never holds more than the
+                // read-ahead plus one delimiter.
+                size_t safe = stream.available() >= delimiter.size()
+                    ? stream.available() - delimiter.size() + 1
+                    : 0;
+                edjx::error::StreamError err = emit(sink, begin, safe);
+                if (err != edjx::error::StreamError::Success) {
+                    return err;
+                }
+                err = stream.fill(stream.available() + 1);
+                if (err == edjx::error::StreamError::EndOfStream) {
+                    return edjx::error::StreamError::Unknown;
+                }
+                if (err != edjx::error::StreamError::Success) {
+                    return err;
+                }
+            }
+        }
+
+        template <typename Sink>
+        inline edjx::error::StreamError emit(Sink & sink, const uint8_t * data, size_t size) {
+            if (size == 0) {
+                return edjx::error::StreamError::Success;
+            }
+            edjx::error::StreamError err = sink(data, size);
+            stream.consume(size);
+            return err;
+        }
+
+        /// Skips everything up to and including the first `--boundary`.
+        inline edjx::error::StreamError skip_preamble() {
+            // The first delimiter may be at the very start of the body,
+            // without the leading line break.
+            const char * first = delimiter.data() + 2;
+            size_t first_size = delimiter.size() - 2;
+            const uint8_t * data = nullptr;
+            size_t size = 0;
+            edjx::error::StreamError err = stream.peek(first_size, data, size);
+            if (err != edjx::error::StreamError::Success && err != edjx::error::StreamError::EndOfStream) {
+                return err;
+            }
+            if (size == first_size && std::memcmp(data, first, first_size) == 0) {
+                stream.consume(first_size);
+                state = State::Boundary;
+                return edjx::error::StreamError::Success;
+            }
+            state = State::Body;
+            return skip_part();
+        }
+
+        /// Reads the rest of a boundary line: `--` for the last part, or a line break.
+        inline edjx::error::StreamError read_boundary_end() {
+            const uint8_t * data = nullptr;
+            size_t size = 0;
+            edjx::error::StreamError err = stream.peek(2, data, size);
+            if (err != edjx::error::StreamError::Success) {
+                return err == edjx::error::StreamError::EndOfStream ? edjx::error::StreamError::Unknown : err;
+            }
+            if (data[0] == '-' && data[1] == '-') {
+                state = State::Done;
+                return edjx::error::StreamError::Success;
+            }
+            size_t line_end = 0;
+            err = stream.find(reinterpret_cast<const uint8_t *>("\r\n"), 2, line_end);
+            if (err != edjx::error::StreamError::Success) {
+                return err == edjx::error::StreamError::EndOfStream ? edjx::error::StreamError::Unknown : err;
+            }
+            // Only transport padding (whitespace) may follow the boundary.
+            for (size_t i = 0; i < line_end; i++) {
+                if (stream.data()[i] != ' ' && stream.data()[i] != '\t') {
+                    return edjx::error::StreamError::Unknown;
+                }
+            }
+            stream.consume(line_end + 2);
+            return edjx::error::StreamError::Success;
+        }
+
+        inline edjx::error::StreamError read_headers(Part & part) {
+            part = Part();
+            size_t scanned = 0;
+            size_t headers_end = 0;
+            while (true) {
+                const uint8_t * begin = stream.data();
+                size_t size = stream.available();
+                if (size >= 2 && begin[0] == '\r' && begin[1] == '\n') {
+                    stream.consume(2);
+                    return edjx::error::StreamError::Success;
+                }
+                const uint8_t * p = begin + scanned;
+                const uint8_t * end = begin + size;
+                bool found = false;
+                while (end - p >= 4) {
+                    p = simd::find_first_of(p, end - 3, '\r');
+                    if (p == end - 3) {
+                        break;
+                    }
+                    if (std::memcmp(p, "\r\n\r\n", 4) == 0) {
+                        found = true;
+                        break;
+                    }
+                    p++;
+                }
+                if (found) {
+                    headers_end = p - begin;
+                    break;
+                }
+                if (size > max_header_size) {
+                    return edjx::error::StreamError::StreamChunkTooLarge;
+                }
+                scanned = size >= 3 ? size - 3 : 0;
+                edjx::error::StreamError err = stream.fill(size + 1);
+                if (err != edjx::error::StreamError::Success) {
+                    return err == edjx::error::StreamError::EndOfStream ? edjx::error::StreamError::Unknown : err;
+                }
+            }
+
+            const char * text = reinterpret_cast<const char *>(stream.data());
+            size_t line_start = 0;
+            while (line_start < headers_end) {
+                const char * line_end_ptr = static_cast<const char *>(
+                    std::memchr(text + line_start, '\r', headers_end - line_start));
+                size_t line_end = line_end_ptr ? line_end_ptr - text : headers_end;
+                const char * colon = static_cast<const char *>(
+                    std::memchr(text + line_start, ':', line_end - line_start));
+                if (colon == nullptr) {
+                    return edjx::error::StreamError::Unknown;
+                }
+                std::string name(text + line_start, colon - text - line_start);
+                size_t value_start = colon - text + 1;
+                while (value_start < line_end && (text[value_start] == ' ' || text[value_start] == '\t')) {
+                    value_start++;
+                }
+                size_t value_end = line_end;
+                while (value_end > value_start && (text[value_end - 1] == ' ' || text[value_end - 1] == '\t')) {
+                    value_end--;
+                }
+                part.headers[name].push_back(std::string(text + value_start, value_end - value_start));
+                line_start = line_end + 2;
+            }
+            stream.consume(headers_end + 4);
+
+            auto disposition = part.headers.find("Content-Disposition");
+            if (disposition != part.headers.end() && !disposition->second.empty()) {
+                part.name = detail::get_parameter(disposition->second.front(), "name");
+                part.filename = detail::get_parameter(disposition->second.front(), "filename");
+            }
+            auto content_type = part.headers.find("Content-Type");
+            if (content_type != part.headers.end() && !content_type->second.empty()) {
+                part.content_type = content_type->second.front();
+            }
+            return edjx::error::StreamError::Success;
+        }
+
+        edjx::stream::BufferedReadStream & stream;
+        std::string delimiter;
+        size_t max_header_size;
+        State state;
+    };
+
+}}
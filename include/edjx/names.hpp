@@ -0,0 +1,481 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "http.hpp"
+
+// Compile-time tables of HTTP method, version, status and header names.
+// The lookups neither allocate nor call into the library, and all tables
+// are constant data, so they add no static initializers.
+
+namespace edjx {
+namespace http {
+
+    /**
+     * @brief Returns the name of an HTTP method (e.g., "GET").
+     *
+     * @param method HTTP method
+     * @return Method name, or an empty string for HttpMethod::NONE
+     */
+    constexpr std::string_view method_name(HttpMethod method) {
+        constexpr std::string_view names[] = {
+            "", "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH"
+        };
+        size_t index = static_cast<size_t>(method);
+        return index < sizeof(names) / sizeof(names[0]) ? names[index] : std::string_view();
+    }
+
+    /**
+     * @brief Parses an HTTP method name. Method names are case-sensitive.
+     *
+     * @param name Method name
+     * @return HTTP method, or HttpMethod::NONE if the name is unknown
+     */
+    constexpr HttpMethod parse_method(std::string_view name) {
+        for (int i = static_cast<int>(HttpMethod::GET); i <= static_cast<int>(HttpMethod::PATCH); i++) {
+            if (method_name(static_cast<HttpMethod>(i)) == name) {
+                return static_cast<HttpMethod>(i);
+            }
+        }
+        return HttpMethod::NONE;
+    }
+
+    /**
+     * @brief Returns the name of an HTTP version (e.g., "HTTP/1.1").
+     *
+     * @param version HTTP version
+     * @return Version name
+     */
+    constexpr std::string_view version_name(HttpVersion version) {
+        constexpr std::string_view names[] = {
+            "HTTP/0.9", "HTTP/1.0", "HTTP/1.1", "HTTP/2.0", "HTTP/3.0"
+        };
+        size_t index = static_cast<size_t>(version);
+        return index < sizeof(names) / sizeof(names[0]) ? names[index] : std::string_view();
+    }
+
+    /**
+     * @brief Parses an HTTP version name. "HTTP/2" and "HTTP/3" are
+     * accepted as well.
+     *
+     * @param name Version name
+     * @param result Parsed HTTP version
+     * @return true The name is a known version
+     * @return false The name is unknown; `result` is unchanged
+     */
+    constexpr bool parse_version(std::string_view name, HttpVersion & result) {
+        for (int i = static_cast<int>(HttpVersion::HTTP_09); i <= static_cast<int>(HttpVersion::HTTP_3); i++) {
+            if (version_name(static_cast<HttpVersion>(i)) == name) {
+                result = static_cast<HttpVersion>(i);
+                return true;
+            }
+        }
+        if (name == "HTTP/2") {
+            result = HttpVersion::HTTP_2;
+            return true;
+        }
+        if (name == "HTTP/3") {
+            result = HttpVersion::HTTP_3;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the reason phrase of an HTTP status code
+     * (e.g., "Not Found" for 404).
+     *
+     * @param status HTTP status code
+     * @return Reason phrase, or an empty string for unregistered codes
+     */
+    constexpr std::string_view reason_phrase(HttpStatusCode status) {
+        switch (status) {
+            case 100: return "Continue";
+            case 101: return "Switching Protocols";
+            case 102: return "Processing";
+            case 103: return "Early Hints";
+            case 200: return "OK";
+            case 201: return "Created";
+            case 202: return "Accepted";
+            case 203: return "Non-Authoritative Information";
+            case 204: return "No Content";
+            case 205: return "Reset Content";
+            case 206: return "Partial Content";
+            case 207: return "Multi-Status";
+            case 208: return "Already Reported";
+            case 226: return "IM Used";
+            case 300: return "Multiple Choices";
+            case 301: return "Moved Permanently";
+            case 302: return "Found";
+            case 303: return "See Other";
+            case 304: return "Not Modified";
+            case 305: return "Use Proxy";
+            case 307: return "Temporary Redirect";
+            case 308: return "Permanent Redirect";
+            case 400: return "Bad Request";
+            case 401: return "Unauthorized";
+            case 402: return "Payment Required";
+            case 403: return "Forbidden";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 406: return "Not Acceptable";
+            case 407: return "Proxy Authentication Required";
+            case 408: return "Request Timeout";
+            case 409: return "Conflict";
+            case 410: return "Gone";
+            case 411: return "Length Required";
+            case 412: return "Precondition Failed";
+            case 413: return "Content Too Large";
+            case 414: return "URI Too Long";
+            case 415: return "Unsupported Media Type";
+            case 416: return "Range Not Satisfiable";
+            case 417: return "Expectation Failed";
+            case 421: return "Misdirected Request";
+            case 422: return "Unprocessable Content";
+            case 423: return "Locked";
+            case 424: return "Failed Dependency";
+            case 425: return "Too Early";
+            case 426: return "Upgrade Required";
+            case 428: return "Precondition Required";
+            case 429: return "Too Many Requests";
+            case 431: return "Request Header Fields Too Large";
+            case 451: return "Unavailable For Legal Reasons";
+            case 500: return "Internal Server Error";
+            case 501: return "Not Implemented";
+            case 502: return "Bad Gateway";
+            case 503: return "Service Unavailable";
+            case 504: return "Gateway Timeout";
+            case 505: return "HTTP Version Not Supported";
+            case 506: return "Variant Also Negotiates";
+            case 507: return "Insufficient Storage";
+            case 508: return "Loop Detected";
+            case 511: return "Network Authentication Required";
+            default: return std::string_view();
+        }
+    }
+
+    /**
+     * @brief Interned IDs of well-known header names.
+     *
+     * Comparing IDs is an integer compare, while comparing header names
+     * is a case-insensitive string compare.
+     */
+    enum class HeaderId : uint8_t {
+        /// Not a well-known header name
+        Unknown = 0,
+        Accept,
+        AcceptCharset,
+        AcceptEncoding,
+        AcceptLanguage,
+        AcceptPatch,
+        AcceptPost,
+        AcceptRanges,
+        AccessControlAllowCredentials,
+        AccessControlAllowHeaders,
+        AccessControlAllowMethods,
+        AccessControlAllowOrigin,
+        AccessControlExposeHeaders,
+        AccessControlMaxAge,
+        AccessControlRequestHeaders,
+        AccessControlRequestMethod,
+        Age,
+        Allow,
+        AltSvc,
+        Authorization,
+        CacheControl,
+        ClearSiteData,
+        Connection,
+        ContentDisposition,
+        ContentEncoding,
+        ContentLanguage,
+        ContentLength,
+        ContentLocation,
+        ContentRange,
+        ContentSecurityPolicy,
+        ContentSecurityPolicyReportOnly,
+        ContentType,
+        Cookie,
+        CrossOriginEmbedderPolicy,
+        CrossOriginOpenerPolicy,
+        CrossOriginResourcePolicy,
+        Date,
+        Dnt,
+        EarlyData,
+        ETag,
+        Expect,
+        Expires,
+        Forwarded,
+        From,
+        Host,
+        IfMatch,
+        IfModifiedSince,
+        IfNoneMatch,
+        IfRange,
+        IfUnmodifiedSince,
+        KeepAlive,
+        LastModified,
+        Link,
+        Location,
+        MaxForwards,
+        Origin,
+        PermissionsPolicy,
+        Pragma,
+        ProxyAuthenticate,
+        ProxyAuthorization,
+        Range,
+        Referer,
+        ReferrerPolicy,
+        RetryAfter,
+        SecFetchDest,
+        SecFetchMode,
+        SecFetchSite,
+        SecFetchUser,
+        Server,
+        ServerTiming,
+        SetCookie,
+        StrictTransportSecurity,
+        Te,
+        TimingAllowOrigin,
+        Trailer,
+        TransferEncoding,
+        Upgrade,
+        UpgradeInsecureRequests,
+        UserAgent,
+        Vary,
+        Via,
+        WwwAuthenticate,
+        XContentTypeOptions,
+        XForwardedFor,
+        XForwardedHost,
+        XForwardedProto,
+        XFrameOptions,
+        XRequestId,
+        XXssProtection,
+    };
+
+    namespace detail {
+
+        constexpr std::string_view HEADER_NAMES[] = {
+            "",
+            "Accept",
+            "Accept-Charset",
+            "Accept-Encoding",
+            "Accept-Language",
+            "Accept-Patch",
+            "Accept-Post",
+            "Accept-Ranges",
+            "Access-Control-Allow-Credentials",
+            "Access-Control-Allow-Headers",
+            "Access-Control-Allow-Methods",
+            "Access-Control-Allow-Origin",
+            "Access-Control-Expose-Headers",
+            "Access-Control-Max-Age",
+            "Access-Control-Request-Headers",
+            "Access-Control-Request-Method",
+            "Age",
+            "Allow",
+            "Alt-Svc",
+            "Authorization",
+            "Cache-Control",
+            "Clear-Site-Data",
+            "Connection",
+            "Content-Disposition",
+            "Content-Encoding",
+            "Content-Language",
+            "Content-Length",
+            "Content-Location",
+            "Content-Range",
+            "Content-Security-Policy",
+            "Content-Security-Policy-Report-Only",
+            "Content-Type",
+            "Cookie",
+            "Cross-Origin-Embedder-Policy",
+            "Cross-Origin-Opener-Policy",
+            "Cross-Origin-Resource-Policy",
+            "Date",
+            "DNT",
+            "Early-Data",
+            "ETag",
+            "Expect",
+            "Expires",
+            "Forwarded",
+            "From",
+            "Host",
+            "If-Match",
+            "If-Modified-Since",
+            "If-None-Match",
+            "If-Range",
+            "If-Unmodified-Since",
+            "Keep-Alive",
+            "Last-Modified",
+            "Link",
+            "Location",
+            "Max-Forwards",
+            "Origin",
+            "Permissions-Policy",
+            "Pragma",
+            "Proxy-Authenticate",
+            "Proxy-Authorization",
+            "Range",
+            "Referer",
+            "Referrer-Policy",
+            "Retry-After",
+            "Sec-Fetch-Dest",
+            "Sec-Fetch-Mode",
+            "Sec-Fetch-Site",
+            "Sec-Fetch-User",
+            "Server",
+            "Server-Timing",
+            "Set-Cookie",
+            "Strict-Transport-Security",
+            "TE",
+            "Timing-Allow-Origin",
+            "Trailer",
+            "Transfer-Encoding",
+            "Upgrade",
+            "Upgrade-Insecure-Requests",
+            "User-Agent",
+            "Vary",
+            "Via",
+            "WWW-Authenticate",
+            "X-Content-Type-Options",
+            "X-Forwarded-For",
+            "X-Forwarded-Host",
+            "X-Forwarded-Proto",
+            "X-Frame-Options",
+            "X-Request-ID",
+            "X-XSS-Protection",
+        };
+
+        constexpr size_t HEADER_COUNT = sizeof(HEADER_NAMES) / sizeof(HEADER_NAMES[0]);
+
+        /// Number of slots of the header name hash table (a power of two)
+        constexpr size_t HEADER_SLOTS = 256;
+
+        constexpr uint8_t fold_case(char c) {
+            return c >= 'A' && c <= 'Z' ? static_cast<uint8_t>(c | 0x20) : static_cast<uint8_t>(c);
+        }
+
+        /// Case-insensitive FNV-1a
+        constexpr uint32_t hash_header_name(std::string_view name) {
+            uint32_t hash = 2166136261u;
+            for (char c : name) {
+                hash = (hash ^ fold_case(c)) * 16777619u;
+            }
+            return hash;
+        }
+
+        constexpr bool equals_ignore_case(std::string_view name, std::string_view canonical) {
+            if (name.size() != canonical.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < name.size(); i++) {
+                if (fold_case(name[i]) != fold_case(canonical[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Open addressing with linear probing; slot value 0 is empty.
+        constexpr std::array<uint8_t, HEADER_SLOTS> build_header_table() {
+            std::array<uint8_t, HEADER_SLOTS> table {};
+            for (size_t id = 1; id < HEADER_COUNT; id++) {
+                size_t slot = hash_header_name(HEADER_NAMES[id]) & (HEADER_SLOTS - 1);
+                while (table[slot] != 0) {
+                    slot = (slot + 1) & (HEADER_SLOTS - 1);
+                }
+                table[slot] = static_cast<uint8_t>(id);
+            }
+            return table;
+        }
+
+        constexpr std::array<uint8_t, HEADER_SLOTS> HEADER_TABLE = build_header_table();
+
+        constexpr size_t longest_header_probe() {
+            size_t longest = 0;
+            for (size_t id = 1; id < HEADER_COUNT; id++) {
+                size_t slot = hash_header_name(HEADER_NAMES[id]) & (HEADER_SLOTS - 1);
+                size_t probes = 1;
+                while (HEADER_TABLE[slot] != id) {
+                    slot = (slot + 1) & (HEADER_SLOTS - 1);
+                    probes++;
+                }
+                longest = probes > longest ? probes : longest;
+            }
+            return longest;
+        }
+
+        static_assert(HEADER_COUNT < HEADER_SLOTS / 2, "header table is too full");
+        static_assert(longest_header_probe() <= 4, "header table has long probe sequences");
+
+    }
+
+    /**
+     * @brief Returns the interned ID of a header name.
+     *
+     * @param name Header name in any letter case
+     * @return ID of the header, or HeaderId::Unknown if the name is not
+     * a well-known header
+     */
+    constexpr HeaderId intern_header(std::string_view name) {
+        size_t slot = detail::hash_header_name(name) & (detail::HEADER_SLOTS - 1);
+        while (detail::HEADER_TABLE[slot] != 0) {
+            uint8_t id = detail::HEADER_TABLE[slot];
+            if (detail::equals_ignore_case(name, detail::HEADER_NAMES[id])) {
+                return static_cast<HeaderId>(id);
+            }
+            slot = (slot + 1) & (detail::HEADER_SLOTS - 1);
+        }
+        return HeaderId::Unknown;
+    }
+
+    /**
+     * @brief Returns the canonical name of a header (e.g., "Content-Type").
+     *
+     * @param id Header ID
+     * @return Header name, or an empty string for HeaderId::Unknown
+     */
+    constexpr std::string_view header_name(HeaderId id) {
+        size_t index = static_cast<size_t>(id);
+        return index < detail::HEADER_COUNT ? detail::HEADER_NAMES[index] : std::string_view();
+    }
+
+    /**
+     * @brief Returns the canonical name of a header as a string that can
+     * be used as an HttpHeaders key without building a new string.
+     *
+     * The strings are created on first use.
+     *
+     * @param id Header ID
+     * @return Header name
+     */
+    inline const std::string & header_key(HeaderId id) {
+        static const std::array<std::string, detail::HEADER_COUNT> keys = [] {
+            std::array<std::string, detail::HEADER_COUNT> result;
+            for (size_t i = 0; i < detail::HEADER_COUNT; i++) {
+                result[i] = std::string(detail::HEADER_NAMES[i]);
+            }
+            return result;
+        }();
+        size_t index = static_cast<size_t>(id);
+        return keys[index < detail::HEADER_COUNT ? index : 0];
+    }
+
+    /**
+     * @brief Returns the values of a well-known header.
+     *
+     * @param headers Headers
+     * @param id Header ID
+     * @return Values of the header, or nullptr if the header is not present
+     */
+    inline const std::vector<std::string> * find_header(const HttpHeaders & headers, HeaderId id) {
+        HttpHeaders::const_iterator found = headers.find(header_key(id));
+        return found == headers.end() ? nullptr : &found->second;
+    }
+
+}}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <strings.h>
+
+#include "error.hpp"
+#include "fetch.hpp"
+#include "http.hpp"
+#include "request.hpp"
+#include "response.hpp"
+#include "stream.hpp"
+
+namespace edjx {
+
+/**
+ * @brief Streaming reverse proxy.
+ *
+ * edjx::proxy::forward() sends the client request to an upstream server
+ * and relays the upstream response to the client. Both bodies are piped
+ * between streams by the host, so they are never copied into the memory
+ * of the function, and memory use does not depend on the body size.
+ */
+namespace proxy {
+
+    /**
+     * @brief Header changes applied to a forwarded request or response.
+     */
+    struct HeaderEdits {
+        /// Headers to remove (case-insensitive names)
+        std::vector<std::string> remove;
+        /// Headers to set, replacing any forwarded values
+        edjx::http::HttpHeaders set;
+    };
+
+    /**
+     * @brief Check whether a header applies only to a single connection
+     * and must not be forwarded.
+     *
+     * `Content-Length` is included because forwarded bodies are streamed,
+     * and `Host` because it must name the upstream server.
+     *
+     * @param header_name Header name
+     * @return true The header is not forwarded
+     * @return false The header is forwarded
+     */
+    inline bool is_hop_by_hop_header(const std::string & header_name) {
+        static const char * const names[] = {
+            "Connection", "Keep-Alive", "Proxy-Authenticate", "Proxy-Authorization",
+            "Proxy-Connection", "TE", "Trailer", "Transfer-Encoding", "Upgrade",
+            "Content-Length", "Host"
+        };
+        for (const char * name : names) {
+            if (strcasecmp(header_name.c_str(), name) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Copies forwardable headers and applies header edits.
+     *
+     * @param headers Original headers
+     * @param edits Changes to apply
+     * @return Headers to forward
+     */
+    inline edjx::http::HttpHeaders forwarded_headers(
+        const edjx::http::HttpHeaders & headers,
+        const HeaderEdits & edits
+    ) {
+        edjx::http::HttpHeaders result;
+        for (const auto & header : headers) {
+            if (!is_hop_by_hop_header(header.first)) {
+                result.insert(header);
+            }
+        }
+        for (const std::string & name : edits.remove) {
+            result.erase(name);
+        }
+        for (const auto & header : edits.set) {
+            result[header.first] = header.second;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Forwards a client request to an upstream server and streams
+     * the upstream response back to the client.
+     *
+     * The request body is piped from edjx::request::HttpRequest::open_read_stream()
+     * into the upstream request, and the upstream response body is piped
+     * into the client response. If an error is returned before the response
+     * was started, the function may still send its own response
+     * (e.g., `502 Bad Gateway`).
+     *
+     * @param request Client request
+     * @param upstream URI of the upstream server
+     * @param request_edits Changes to the forwarded request headers
+     * @param response_edits Changes to the forwarded response headers
+     * @return Returns edjx::error::HttpError::Success on success,
+     * some other value on failure.
+     */
+    inline edjx::error::HttpError forward(
+        edjx::request::HttpRequest & request,
+        const edjx::http::Uri & upstream,
+        const HeaderEdits & request_edits = HeaderEdits(),
+        const HeaderEdits & response_edits = HeaderEdits()
+    ) {
+        edjx::fetch::HttpFetch fetch(upstream, request.get_method());
+        fetch.set_headers(forwarded_headers(request.get_headers(), request_edits));
+
+        edjx::fetch::FetchResponsePending pending;
+        edjx::stream::WriteStream upstream_body;
+        edjx::error::HttpError err = fetch.send_streaming(pending, upstream_body);
+        if (err != edjx::error::HttpError::Success) {
+            return err;
+        }
+
+        edjx::http::HttpMethod method = request.get_method();
+        if (method == edjx::http::HttpMethod::GET || method == edjx::http::HttpMethod::HEAD) {
+            upstream_body.close();
+        } else {
+            edjx::stream::ReadStream client_body;
+            err = request.open_read_stream(client_body);
+            if (err != edjx::error::HttpError::Success) {
+                upstream_body.abort();
+                return err;
+            }
+            if (client_body.pipe_to(upstream_body) != edjx::error::StreamError::Success) {
+                upstream_body.abort();
+                return edjx::error::HttpError::HTTPFetchRequestFailed;
+            }
+        }
+
+        edjx::fetch::FetchResponse upstream_response;
+        err = pending.get_fetch_response(upstream_response);
+        if (err != edjx::error::HttpError::Success) {
+            return err;
+        }
+
+        edjx::response::HttpResponse response;
+        response.set_status(upstream_response.get_status_code());
+        response.set_headers(forwarded_headers(upstream_response.get_headers(), response_edits));
+        edjx::stream::WriteStream client_response;
+        err = response.send_streaming(client_response);
+        if (err != edjx::error::HttpError::Success) {
+            return err;
+        }
+        if (upstream_response.get_read_stream().pipe_to(client_response) != edjx::error::StreamError::Success) {
+            return edjx::error::HttpError::HTTPChannelClosed;
+        }
+        return edjx::error::HttpError::Success;
+    }
+
+    /**
+     * @brief Forwards the request being handled by the serverless function
+     * to an upstream server and streams the upstream response back.
+     *
+     * @param upstream URI of the upstream server
+     * @param request_edits Changes to the forwarded request headers
+     * @param response_edits Changes to the forwarded response headers
+     * @return Returns edjx::error::HttpError::Success on success,
+     * some other value on failure.
+     */
+    inline edjx::error::HttpError forward(
+        const edjx::http::Uri & upstream,
+        const HeaderEdits & request_edits = HeaderEdits(),
+        const HeaderEdits & response_edits = HeaderEdits()
+    ) {
+        edjx::request::HttpRequest request;
+        edjx::error::HttpError err = edjx::request::HttpRequest::from_client(request);
+        if (err != edjx::error::HttpError::Success) {
+            return err;
+        }
+        return forward(request, upstream, request_edits, response_edits);
+    }
+
+}}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "error.hpp"
+#include "simd.hpp"
+#include "stream.hpp"
+
+// Record readers that run over a stream in bounded memory. Records may be
+// split across chunks; the readers keep at most one record (plus the
+// read-ahead of the underlying BufferedReadStream) in memory, and return
+// views into that buffer. A returned view is valid until the next call
+// to next().
+
+namespace edjx {
+namespace stream {
+
+    /// Default limit on the size of one record in bytes
+    constexpr size_t DEFAULT_MAX_RECORD_SIZE = 1024 * 1024;
+
+    /**
+     * @brief Reads newline-delimited records (e.g., NDJSON or log lines).
+     *
+     * Both `\n` and `\r\n` line endings are accepted. A last line without
+     * a line ending is returned as a record too.
+     */
+    class LineReader {
+    public:
+        /**
+         * @brief Constructs a line reader.
+         *
+         * @param stream Buffered stream to read from
+         * @param max_record_size Longest accepted line in bytes
+         */
+        inline explicit LineReader(
+            BufferedReadStream & stream,
+            size_t max_record_size = DEFAULT_MAX_RECORD_SIZE
+        ) : stream(stream),
+            max_record_size(max_record_size),
+            pending(0) {}
+
+        /**
+         * @brief Reads the next line.
+         *
+         * @param line The line without its line ending
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream if there are no more lines,
+         * edjx::error::StreamError::StreamChunkTooLarge if a line is longer
+         * than the limit, some other value on failure.
+         */
+        inline edjx::error::StreamError next(std::string_view & line) {
+            stream.consume(pending);
+            pending = 0;
+            size_t from = 0;
+            while (true) {
+                const uint8_t * begin = stream.data();
+                size_t size = stream.available();
+                const uint8_t * hit = simd::find_first_of(begin + from, begin + size, '\n');
+                if (hit != begin + size) {
+                    size_t length = hit - begin;
+                    pending = length + 1;
+                    if (length > 0 && begin[length - 1] == '\r') {
+                        length--;
+                    }
+                    line = std::string_view(reinterpret_cast<const char *>(begin), length);
+                    return edjx::error::StreamError::Success;
+                }
+                if (size > max_record_size) {
+                    return edjx::error::StreamError::StreamChunkTooLarge;
+                }
+                from = size;
+                edjx::error::StreamError err = stream.fill(size + 1);
+                if (err == edjx::error::StreamError::EndOfStream) {
+                    if (size == 0) {
+                        return err;
+                    }
+                    pending = size;
+                    line = std::string_view(reinterpret_cast<const char *>(stream.data()), size);
+                    return edjx::error::StreamError::Success;
+                }
+                if (err != edjx::error::StreamError::Success) {
+                    return err;
+                }
+            }
+        }
+
+    private:
+        BufferedReadStream & stream;
+        size_t max_record_size;
+        size_t pending;
+    };
+
+    /**
+     * @brief Reads CSV records (RFC 4180).
+     *
+     * Quoted fields may contain separators, line breaks and doubled
+     * quotes (`""`). Fields are returned without quotes; only fields with
+     * doubled quotes are copied, all others point into the stream buffer.
+     */
+    class CsvReader {
+    public:
+        /**
+         * @brief Constructs a CSV reader.
+         *
+         * @param stream Buffered stream to read from
+         * @param separator Field separator
+         * @param max_record_size Longest accepted record in bytes
+         */
+        inline explicit CsvReader(
+            BufferedReadStream & stream,
+            char separator = ',',
+            size_t max_record_size = DEFAULT_MAX_RECORD_SIZE
+        ) : stream(stream),
+            separator(static_cast<uint8_t>(separator)),
+            max_record_size(max_record_size),
+            pending(0) {}
+
+        /**
+         * @brief Reads the next record.
+         *
+         * @param fields Fields of the record
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream if there are no more records,
+         * edjx::error::StreamError::StreamChunkTooLarge if a record is longer
+         * than the limit, some other value on failure.
+         */
+        inline edjx::error::StreamError next(std::vector<std::string_view> & fields) {
+            stream.consume(pending);
+            pending = 0;
+            size_t from = 0;
+            bool quoted = false;
+            while (true) {
+                const uint8_t * begin = stream.data();
+                size_t size = stream.available();
+                const uint8_t * end = begin + size;
+                const uint8_t * p = begin + from;
+                while (true) {
+                    p = simd::find_first_of(p, end, '"', '\n');
+                    if (p == end || (*p == '\n' && !quoted)) {
+                        break;
+                    }
+                    if (*p == '"') {
+                        quoted = !quoted;
+                    }
+                    p++;
+                }
+                if (p != end) {
+                    pending = p - begin + 1;
+                    split(begin, p - begin, fields);
+                    return edjx::error::StreamError::Success;
+                }
+                if (size > max_record_size) {
+                    return edjx::error::StreamError::StreamChunkTooLarge;
+                }
+                from = size;
+                edjx::error::StreamError err = stream.fill(size + 1);
+                if (err == edjx::error::StreamError::EndOfStream) {
+                    if (size == 0) {
+                        return err;
+                    }
+                    pending = size;
+                    split(stream.data(), size, fields);
+                    return edjx::error::StreamError::Success;
+                }
+                if (err != edjx::error::StreamError::Success) {
+                    return err;
+                }
+            }
+        }
+
+    private:
+        inline void split(const uint8_t * record, size_t length, std::vector<std::string_view> & fields) {
+            if (length > 0 && record[length - 1] == '\r') {
+                length--;
+            }
+            const uint8_t * end = record + length;
+            fields.clear();
+            unescaped.clear();
+            // Unescaped fields are never longer than the record, so views
+            // into `unescaped` stay valid while it grows.
+            unescaped.reserve(length);
+            const uint8_t * p = record;
+            while (true) {
+                if (p < end && *p == '"') {
+                    const uint8_t * content = ++p;
+                    bool escaped = false;
+                    while (true) {
+                        p = simd::find_byte(p, end, '"');
+                        if (p + 1 < end && p[1] == '"') {
+                            escaped = true;
+                            p += 2;
+                            continue;
+                        }
+                        break;
+                    }
+                    if (escaped) {
+                        size_t offset = unescaped.size();
+                        for (const uint8_t * q = content; q < p; q++) {
+                            unescaped.push_back(static_cast<char>(*q));
+                            if (*q == '"') {
+                                q++;
+                            }
+                        }
+                        fields.emplace_back(unescaped.data() + offset, unescaped.size() - offset);
+                    } else {
+                        fields.emplace_back(reinterpret_cast<const char *>(content), p - content);
+                    }
+                    p = simd::find_byte(p, end, separator);
+                } else {
+                    const uint8_t * field_end = simd::find_byte(p, end, separator);
+                    fields.emplace_back(reinterpret_cast<const char *>(p), field_end - p);
+                    p = field_end;
+                }
+                if (p >= end) {
+                    return;
+                }
+                p++;
+            }
+        }
+
+        BufferedReadStream & stream;
+        uint8_t separator;
+        size_t max_record_size;
+        size_t pending;
+        std::string unescaped;
+    };
+
+    /**
+     * @brief Reads binary records that are each preceded by their length
+     * as a 32-bit big-endian unsigned integer.
+     */
+    class LengthPrefixedReader {
+    public:
+        /// Size of the length prefix in bytes
+        static constexpr size_t PREFIX_SIZE = 4;
+
+        /**
+         * @brief Constructs a length-prefixed record reader.
+         *
+         * @param stream Buffered stream to read from
+         * @param max_record_size Largest accepted record in bytes
+         */
+        inline explicit LengthPrefixedReader(
+            BufferedReadStream & stream,
+            size_t max_record_size = DEFAULT_MAX_RECORD_SIZE
+        ) : stream(stream),
+            max_record_size(max_record_size),
+            pending(0) {}
+
+        /**
+         * @brief Reads the next record.
+         *
+         * @param record Record bytes without the length prefix
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream if there are no more records,
+         * edjx::error::StreamError::StreamChunkTooLarge if a record is larger
+         * than the limit, edjx::error::StreamError::Unknown if the stream
+         * ends in the middle of a record, some other value on failure.
+         */
+        inline edjx::error::StreamError next(std::string_view & record) {
+            stream.consume(pending);
+            pending = 0;
+            edjx::error::StreamError err = stream.fill(PREFIX_SIZE);
+            if (err == edjx::error::StreamError::EndOfStream) {
+                return stream.available() == 0 ? err : edjx::error::StreamError::Unknown;
+            }
+            if (err != edjx::error::StreamError::Success) {
+                return err;
+            }
+            const uint8_t * prefix = stream.data();
+            size_t length = (static_cast<size_t>(prefix[0]) << 24)
+                | (static_cast<size_t>(prefix[1]) << 16)
+                | (static_cast<size_t>(prefix[2]) << 8)
+                | static_cast<size_t>(prefix[3]);
+            if (length > max_record_size) {
+                return edjx::error::StreamError::StreamChunkTooLarge;
+            }
+            err = stream.fill(PREFIX_SIZE + length);
+            if (err == edjx::error::StreamError::EndOfStream) {
+                return edjx::error::StreamError::Unknown;
+            }
+            if (err != edjx::error::StreamError::Success) {
+                return err;
+            }
+            pending = PREFIX_SIZE + length;
+            record = std::string_view(reinterpret_cast<const char *>(stream.data()) + PREFIX_SIZE, length);
+            return edjx::error::StreamError::Success;
+        }
+
+    private:
+        BufferedReadStream & stream;
+        size_t max_record_size;
+        size_t pending;
+    };
+
+}}
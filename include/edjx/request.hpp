@@ -4,7 +4,11 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <utility>
+#include <strings.h>
 
+#include "expected.hpp"
+#include "host.hpp"
 #include "http.hpp"
 #include "stream.hpp"
 #include "error.hpp"
@@ -59,6 +63,21 @@ namespace request {
          */
         static edjx::error::HttpError from_client(HttpRequest & result);
 
+        /**
+         * @brief Returns the client request being handled by the
+         * serverless function.
+         * 
+         * @return The request, or the error if execution failed
+         */
+        static inline Expected<HttpRequest, edjx::error::HttpError> from_client() {
+            HttpRequest result;
+            edjx::error::HttpError err = from_client(result);
+            if (err != edjx::error::HttpError::Success) {
+                return err;
+            }
+            return result;
+        }
+
         /**
          * @brief Returns the HTTP method of the request.
          * 
@@ -104,6 +123,208 @@ namespace request {
          * some other value on failure.
          */
         edjx::error::HttpError open_read_stream(edjx::stream::ReadStream & result);
+
+        /**
+         * @brief Opens a read stream to read the request body. The stream
+         * is closed when the returned handle is destroyed.
+         * 
+         * `read_body()` and `open_read_stream()` cannot be used at the same time.
+         * 
+         * @return HTTP request body read stream, or the error on failure
+         */
+        inline Expected<edjx::stream::UniqueReadStream, edjx::error::HttpError> open_read_stream() {
+            edjx::stream::ReadStream result;
+            edjx::error::HttpError err = open_read_stream(result);
+            if (err != edjx::error::HttpError::Success) {
+                return err;
+            }
+            return edjx::stream::UniqueReadStream(result);
+        }
+    };
+
+    /**
+     * @brief Request whose headers are read from the host on demand.
+     * 
+     * HttpRequest::from_client() reads the method, URI and every header
+     * of the request up front. LazyHttpRequest::from_client() reads only
+     * the method and URI; each header is requested from the host the first
+     * time get_header() asks for it, and the full header map is built only
+     * if get_headers() is called or a lookup fails. This is cheaper for
+     * handlers that look at a few headers of header-heavy requests.
+     */
+    struct LazyHttpRequest {
+        /// HTTP method of the request
+        http::HttpMethod method;
+        /// URL of the request
+        http::Uri uri;
+
+        /**
+         * @brief Creates an empty request object with HTTP method of NONE.
+         */
+        LazyHttpRequest()
+            : method(http::HttpMethod::NONE),
+            headers_loaded(false) {}
+
+        /**
+         * @brief Returns the client request being handled by the
+         * serverless function, without reading its headers.
+         * 
+         * @param result LazyHttpRequest in which the request will be stored
+         * @return Returns edjx::error::HttpError::Success on success,
+         * some other value if execution failed.
+         */
+        static inline edjx::error::HttpError from_client(LazyHttpRequest & result) {
+            int32_t method = http_cur_req_get_method();
+            result.method = (method >= 1 && method <= 9)
+                ? static_cast<http::HttpMethod>(method)
+                : http::HttpMethod::NONE;
+
+            int32_t error_code = 0;
+            int32_t size = http_cur_req_get_uri(&error_code);
+            if (size < 1) {
+                return edjx::host::to_http_error(error_code);
+            }
+            std::vector<uint8_t> bytes;
+            if (!edjx::result::get_result_bytes(bytes, size)) {
+                return edjx::error::HttpError::SystemError;
+            }
+            result.uri = http::Uri(bytes);
+            result.looked_up.clear();
+            result.headers.clear();
+            result.headers_loaded = false;
+            return edjx::error::HttpError::Success;
+        }
+
+        /**
+         * @brief Returns the HTTP method of the request.
+         * 
+         * @return HTTP method of the request
+         */
+        inline http::HttpMethod get_method() const {
+            return method;
+        }
+
+        /**
+         * @brief Returns the URL from the request.
+         * 
+         * @return URL of the request
+         */
+        inline http::Uri get_uri() const {
+            return uri;
+        }
+
+        /**
+         * @brief Returns the value of one request header.
+         * 
+         * The header is requested from the host on the first call for the
+         * given name, and the value is cached. A header that is present
+         * with an empty value is reported with an empty `result`. The host
+         * error codes do not tell a missing header apart from a failed
+         * lookup, so a failed lookup is checked against the full header
+         * list (see get_headers()), which is then cached; nothing is cached
+         * if that fails as well.
+         * 
+         * @param header_name Header name (case-insensitive)
+         * @param result Header value will be stored here
+         * @return true The request has the header
+         * @return false The request has no such header, or it could not be read
+         */
+        inline bool get_header(const std::string & header_name, std::string & result) {
+            if (headers_loaded) {
+                auto it = headers.find(header_name);
+                if (it == headers.end() || it->second.empty()) {
+                    return false;
+                }
+                result = it->second.front();
+                return true;
+            }
+            for (const auto & entry : looked_up) {
+                if (strcasecmp(entry.first.c_str(), header_name.c_str()) == 0) {
+                    result = entry.second;
+                    return true;
+                }
+            }
+            int32_t error_code = 0;
+            int32_t size = http_cur_req_get_header_value(
+                reinterpret_cast<const uint8_t *>(header_name.data()),
+                static_cast<uint32_t>(header_name.size()),
+                &error_code
+            );
+            if (size < 0) {
+                return load_headers() == edjx::error::HttpError::Success
+                    && get_header(header_name, result);
+            }
+            std::vector<uint8_t> bytes;
+            if (size > 0 && !edjx::result::get_result_bytes(bytes, size)) {
+                return false;
+            }
+            looked_up.emplace_back(header_name, edjx::utils::to_string(bytes));
+            result = looked_up.back().second;
+            return true;
+        }
+
+        /**
+         * @brief Returns all HTTP headers of the request.
+         * 
+         * The headers are read from the host on the first call.
+         * 
+         * @param result Request headers will be stored here
+         * @return Returns edjx::error::HttpError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::HttpError get_headers(edjx::http::HttpHeaders & result) {
+            edjx::error::HttpError err = load_headers();
+            if (err != edjx::error::HttpError::Success) {
+                return err;
+            }
+            result = headers;
+            return edjx::error::HttpError::Success;
+        }
+
+        /**
+         * @brief Fetches the request body and returns the body as bytes.
+         * 
+         * @param result Received body bytes will be stored here.
+         * @return Returns edjx::error::HttpError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::HttpError read_body(std::vector<uint8_t> & result) {
+            return HttpRequest().read_body(result);
+        }
+
+        /**
+         * @brief Opens a read stream to read the request body.
+         * 
+         * `read_body()` and `open_read_stream()` cannot be used at the same time.
+         * 
+         * @param result HTTP request body read stream
+         * @return Returns edjx::error::HttpError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::HttpError open_read_stream(edjx::stream::ReadStream & result) {
+            return HttpRequest().open_read_stream(result);
+        }
+
+    private:
+        inline edjx::error::HttpError load_headers() {
+            if (!headers_loaded) {
+                HttpRequest request;
+                edjx::error::HttpError err = HttpRequest::from_client(request);
+                if (err != edjx::error::HttpError::Success) {
+                    return err;
+                }
+                headers = std::move(request.headers);
+                headers_loaded = true;
+                looked_up.clear();
+            }
+            return edjx::error::HttpError::Success;
+        }
+
+        /// Headers found by individual lookups: name, value
+        std::vector<std::pair<std::string, std::string>> looked_up;
+        /// All headers, valid if headers_loaded is true
+        edjx::http::HttpHeaders headers;
+        bool headers_loaded;
     };
 
 }}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <map>
 #include <string>
 
+#include "expected.hpp"
 #include "http.hpp"
 #include "stream.hpp"
 #include "error.hpp"
@@ -213,6 +214,8 @@ namespace response {
          * @brief Sends the response to the client using streaming.
          * 
          * This method opens a write stream for the response to the client.
+         * The status and headers are handed to the host by this call,
+         * so they can reach the client before the body is computed.
          * 
          * `send_streaming()` and `send()` cannot be used at the same time.
          * 
@@ -221,6 +224,251 @@ namespace response {
          * some other value on failure.
          */
         edjx::error::HttpError send_streaming(edjx::stream::WriteStream & write_stream);
+
+        /**
+         * @brief Sends the response to the client using streaming.
+         * 
+         * The returned handle owns the write stream and closes it when
+         * destroyed, which ends the response.
+         * 
+         * `send_streaming()` and `send()` cannot be used at the same time.
+         * 
+         * @return Write stream for the response body, or the error on failure
+         */
+        inline Expected<edjx::stream::UniqueWriteStream, edjx::error::HttpError> send_streaming() {
+            edjx::stream::WriteStream write_stream;
+            edjx::error::HttpError err = send_streaming(write_stream);
+            if (err != edjx::error::HttpError::Success) {
+                return err;
+            }
+            return edjx::stream::UniqueWriteStream(write_stream);
+        }
+
+        /**
+         * @brief Starts a server-sent event stream (`text/event-stream`).
+         * 
+         * Sets the headers required by event stream clients and sends them
+         * immediately via send_streaming(). Events are then written with
+         * edjx::response::send_event().
+         * 
+         * @param write_stream The write stream handle will be copied to this object.
+         * @return Returns edjx::error::HttpError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::HttpError send_event_stream(edjx::stream::WriteStream & write_stream) {
+            set_header("Content-Type", "text/event-stream");
+            set_header("Cache-Control", "no-cache");
+            return send_streaming(write_stream);
+        }
+
+        /**
+         * @brief Adds a `Link: <url>; rel=preload` header, so that the
+         * client can start fetching a subresource before the body arrives.
+         *
+         * The host does not send informational (1xx) responses such as
+         * 103 Early Hints. If the final status is known before a slow
+         * operation (e.g., an HttpFetch or edjx::storage::get()), add the
+         * preload links and call send_streaming() first: the status and
+         * headers reach the client right away, and the body is streamed
+         * when it is ready.
+         *
+         * @param url URL of the subresource
+         * @param as Destination of the subresource (e.g., `style`,
+         * `script`, `font`, `image`)
+         * @param crossorigin Whether to add the `crossorigin` attribute
+         * (required for fonts)
+         * @return Reference to this HttpResponse object
+         */
+        inline HttpResponse & add_preload(
+            const std::string & url,
+            const std::string & as,
+            bool crossorigin = false
+        ) {
+            std::string link = "<" + url + ">; rel=preload";
+            if (!as.empty()) {
+                link += "; as=" + as;
+            }
+            if (crossorigin) {
+                link += "; crossorigin";
+            }
+            return append_header("Link", link);
+        }
+
+        /**
+         * @brief Adds a `Link: <origin>; rel=preconnect` header, so that the
+         * client can open a connection to another origin early.
+         *
+         * @param origin Origin to connect to (e.g., `https://cdn.example.com`)
+         * @param crossorigin Whether to add the `crossorigin` attribute
+         * @return Reference to this HttpResponse object
+         */
+        inline HttpResponse & add_preconnect(const std::string & origin, bool crossorigin = false) {
+            std::string link = "<" + origin + ">; rel=preconnect";
+            if (crossorigin) {
+                link += "; crossorigin";
+            }
+            return append_header("Link", link);
+        }
+
+        /**
+         * @brief Sets the ETag header of the response.
+         * 
+         * @param etag Entity tag; quotes are added if it has none
+         * (e.g., `abc` becomes `"abc"`, `W/"abc"` is kept)
+         * @return Reference to this HttpResponse object
+         */
+        inline HttpResponse & set_etag(const std::string & etag) {
+            if (etag.empty() || etag.back() != '"') {
+                return set_header("ETag", "\"" + etag + "\"");
+            }
+            return set_header("ETag", etag);
+        }
+
+        /**
+         * @brief Check whether the client already has the version of the
+         * resource identified by the ETag of this response.
+         * 
+         * @param request_headers Headers of the client request
+         * @return true The If-None-Match header of the request matches
+         * the ETag set by set_etag()
+         * @return false The body has to be sent
+         */
+        inline bool is_not_modified(const edjx::http::HttpHeaders & request_headers) const;
+
+        /**
+         * @brief Turns the response into `304 Not Modified`.
+         * 
+         * The body is removed; the headers (including ETag) are kept.
+         * 
+         * @return Reference to this HttpResponse object
+         */
+        inline HttpResponse & set_not_modified() {
+            set_status(304);
+            return set_body(nullptr, 0);
+        }
+
+        /**
+         * @brief Sends the response, or `304 Not Modified` without the body
+         * if the If-None-Match header of the request matches the ETag.
+         * 
+         * @param request_headers Headers of the client request
+         * @return Returns edjx::error::HttpError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::HttpError send_conditional(const edjx::http::HttpHeaders & request_headers) {
+            if (is_not_modified(request_headers)) {
+                set_not_modified();
+            }
+            return send();
+        }
     };
 
+    /**
+     * @brief Checks an If-None-Match header value against an entity tag
+     * using the weak comparison of RFC 7232.
+     * 
+     * @param if_none_match Value of the If-None-Match header
+     * @param etag Entity tag of the current representation
+     * @return true One of the listed entity tags (or `*`) matches
+     * @return false No entity tag matches
+     */
+    inline bool etag_matches(const std::string & if_none_match, const std::string & etag) {
+        size_t tag_start = etag.compare(0, 2, "W/") == 0 ? 2 : 0;
+        std::string opaque = etag.substr(tag_start);
+        size_t pos = 0;
+        while (pos < if_none_match.size()) {
+            char c = if_none_match[pos];
+            if (c == ' ' || c == '\t' || c == ',') {
+                pos++;
+                continue;
+            }
+            if (c == '*') {
+                return true;
+            }
+            if (if_none_match.compare(pos, 2, "W/") == 0) {
+                pos += 2;
+            }
+            if (pos >= if_none_match.size() || if_none_match[pos] != '"') {
+                return false;
+            }
+            size_t end = if_none_match.find('"', pos + 1);
+            if (end == std::string::npos) {
+                return false;
+            }
+            if (if_none_match.compare(pos, end - pos + 1, opaque) == 0) {
+                return true;
+            }
+            pos = end + 1;
+        }
+        return false;
+    }
+
+    inline bool HttpResponse::is_not_modified(const edjx::http::HttpHeaders & request_headers) const {
+        auto etag = get_headers().find("ETag");
+        auto if_none_match = request_headers.find("If-None-Match");
+        if (etag == get_headers().end() || etag->second.empty()
+                || if_none_match == request_headers.end()) {
+            return false;
+        }
+        for (const std::string & value : if_none_match->second) {
+            if (etag_matches(value, etag->second.front())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Writes one server-sent event as a single chunk.
+     * 
+     * Each event is sent in one host call, so it reaches the client
+     * as soon as this function returns.
+     * 
+     * @param write_stream Stream opened with HttpResponse::send_event_stream()
+     * @param data Event data; it may contain line breaks (`\r\n`, `\r`
+     * or `\n`), each of which starts a new `data:` line
+     * @param event Event type, omitted if empty; must not contain `\r`
+     * or `\n`
+     * @param id Event ID, omitted if empty; must not contain `\r` or `\n`
+     * @return Returns edjx::error::StreamError::Success on success,
+     * edjx::error::StreamError::Unknown if `event` or `id` contains a line
+     * break (nothing is written), some other value on failure.
+     */
+    inline edjx::error::StreamError send_event(
+        edjx::stream::WriteStream & write_stream,
+        const std::string & data,
+        const std::string & event = "",
+        const std::string & id = ""
+    ) {
+        // A line break would end the field and let the rest of the value
+        // be read as other fields of the event.
+        if (event.find_first_of("\r\n") != std::string::npos
+                || id.find_first_of("\r\n") != std::string::npos) {
+            return edjx::error::StreamError::Unknown;
+        }
+        std::string chunk;
+        chunk.reserve(data.size() + event.size() + id.size() + 32);
+        if (!event.empty()) {
+            chunk.append("event: ").append(event).push_back('\n');
+        }
+        if (!id.empty()) {
+            chunk.append("id: ").append(id).push_back('\n');
+        }
+        size_t pos = 0;
+        while (true) {
+            size_t line_break = data.find_first_of("\r\n", pos);
+            chunk.append("data: ").append(data, pos, line_break == std::string::npos ? std::string::npos : line_break - pos);
+            chunk.push_back('\n');
+            if (line_break == std::string::npos) {
+                break;
+            }
+            pos = line_break + 1;
+            if (data[line_break] == '\r' && pos < data.size() && data[pos] == '\n') {
+                pos++;
+            }
+        }
+        chunk.push_back('\n');
+        return write_stream.write_chunk(chunk);
+    }
+
 }}
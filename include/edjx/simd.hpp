@@ -0,0 +1,434 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// The simd128 kernels are opt-in: define EDJX_ENABLE_SIMD128 and build
+// with -msimd128 to use them. They have not yet been built with the
+// WASI SDK clang and checked against the portable (SWAR) kernels, which
+// are used otherwise.
+#if defined(EDJX_ENABLE_SIMD128) && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+/// Defined when the byte kernels use WebAssembly SIMD (simd128) instructions.
+#define EDJX_SIMD128 1
+#endif
+
+namespace edjx {
+
+/// Byte-scanning kernels shared by the parsers in the SDK.
+namespace simd {
+
+    /**
+     * @brief Number of bytes processed by one iteration of the block kernels.
+     */
+    constexpr size_t BLOCK_SIZE = 16;
+
+    /**
+     * @brief Returns the number of trailing zero bits in a non-zero value.
+     */
+    inline unsigned count_trailing_zeros(uint64_t x) {
+        return static_cast<unsigned>(__builtin_ctzll(x));
+    }
+
+    /**
+     * @brief Returns a 64-bit word with `c` in every byte.
+     */
+    constexpr uint64_t broadcast(uint8_t c) {
+        return 0x0101010101010101ULL * c;
+    }
+
+    /**
+     * @brief Returns a word that has the high bit set in the lowest byte
+     * of `x` that is zero.
+     *
+     * Bits above the lowest zero byte may be set spuriously, so only the
+     * lowest set bit of the result is meaningful.
+     */
+    constexpr uint64_t zero_byte_mask(uint64_t x) {
+        return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+    }
+
+    /**
+     * @brief Loads 8 bytes from an unaligned address (little-endian).
+     */
+    inline uint64_t load_word(const uint8_t * p) {
+        uint64_t x;
+        std::memcpy(&x, p, sizeof(x));
+        return x;
+    }
+
+    namespace detail {
+
+        inline bool equals_any(uint8_t) {
+            return false;
+        }
+
+        /// Returns true if `c` is equal to any of the bytes in `chars`.
+        template <typename Char, typename... Chars>
+        inline bool equals_any(uint8_t c, Char first, Chars... chars) {
+            return c == static_cast<uint8_t>(first) || equals_any(c, chars...);
+        }
+
+    }
+
+    /**
+     * @brief Finds the first byte in `[begin, end)` that is equal to
+     * any of the bytes in `chars`.
+     *
+     * @param begin Start of the searched range
+     * @param end End of the searched range
+     * @param chars Bytes to search for
+     * @return Pointer to the first matching byte or `end` if there is none
+     */
+    template <typename... Chars>
+    inline const uint8_t * find_first_of(
+        const uint8_t * begin,
+        const uint8_t * end,
+        Chars... chars
+    ) {
+        const uint8_t * p = begin;
+#if defined(EDJX_SIMD128)
+        while (end - p >= static_cast<ptrdiff_t>(BLOCK_SIZE)) {
+            v128_t block = wasm_v128_load(p);
+            v128_t hits = wasm_i8x16_splat(0);
+            // Pack expansion in an initializer list (C++11 has no fold expressions).
+            int expand[] = {0, (hits = wasm_v128_or(hits,
+                wasm_i8x16_eq(block, wasm_i8x16_splat(static_cast<int8_t>(chars)))), 0)...};
+            (void)expand;
+            uint32_t mask = wasm_i8x16_bitmask(hits);
+            if (mask != 0) {
+                return p + count_trailing_zeros(mask);
+            }
+            p += BLOCK_SIZE;
+        }
+#else
+        while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+            uint64_t word = load_word(p);
+            uint64_t hits = 0;
+            int expand[] = {0, (hits |= zero_byte_mask(word ^ broadcast(static_cast<uint8_t>(chars))), 0)...};
+            (void)expand;
+            if (hits != 0) {
+                // The lowest set bit of every term is exact, so the lowest
+                // bit of their union marks the first match.
+                return p + count_trailing_zeros(hits) / 8;
+            }
+            p += sizeof(uint64_t);
+        }
+#endif
+        for (; p < end; ++p) {
+            if (detail::equals_any(*p, chars...)) {
+                return p;
+            }
+        }
+        return end;
+    }
+
+    /**
+     * @brief Finds the first occurrence of byte `c` in `[begin, end)`.
+     *
+     * @param begin Start of the searched range
+     * @param end End of the searched range
+     * @param c Byte to search for
+     * @return Pointer to the first matching byte or `end` if there is none
+     */
+    inline const uint8_t * find_byte(
+        const uint8_t * begin,
+        const uint8_t * end,
+        uint8_t c
+    ) {
+        if (begin >= end) {
+            return end;
+        }
+        const void * hit = std::memchr(begin, c, static_cast<size_t>(end - begin));
+        return hit ? static_cast<const uint8_t *>(hit) : end;
+    }
+
+    /**
+     * @brief Returns a word that has the high bit set in every byte of `x`
+     * that is an ASCII upper-case letter.
+     */
+    constexpr uint64_t upper_case_mask(uint64_t x) {
+        // Adding to the low 7 bits cannot carry into the next byte.
+        return ((x & 0x7f7f7f7f7f7f7f7fULL) + broadcast(0x80 - 'A'))
+            & ~((x & 0x7f7f7f7f7f7f7f7fULL) + broadcast(0x80 - 'Z' - 1))
+            & ~x & 0x8080808080808080ULL;
+    }
+
+    /**
+     * @brief Converts ASCII upper-case letters in `[begin, end)` to
+     * lower case, in place. Other bytes are not changed.
+     *
+     * @param begin Start of the range
+     * @param end End of the range
+     */
+    inline void to_lower(uint8_t * begin, uint8_t * end) {
+        uint8_t * p = begin;
+#if defined(EDJX_SIMD128)
+        while (end - p >= static_cast<ptrdiff_t>(BLOCK_SIZE)) {
+            v128_t block = wasm_v128_load(p);
+            v128_t upper = wasm_v128_and(
+                wasm_u8x16_ge(block, wasm_i8x16_splat('A')),
+                wasm_u8x16_le(block, wasm_i8x16_splat('Z')));
+            wasm_v128_store(p, wasm_v128_or(block, wasm_v128_and(upper, wasm_i8x16_splat(0x20))));
+            p += BLOCK_SIZE;
+        }
+#else
+        while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+            uint64_t word = load_word(p);
+            word |= upper_case_mask(word) >> 2;
+            std::memcpy(p, &word, sizeof(word));
+            p += sizeof(uint64_t);
+        }
+#endif
+        for (; p < end; ++p) {
+            if (*p >= 'A' && *p <= 'Z') {
+                *p |= 0x20;
+            }
+        }
+    }
+
+    /**
+     * @brief Compares two byte ranges of the same size, ignoring the case
+     * of ASCII letters.
+     *
+     * @param a First range
+     * @param b Second range
+     * @param size Number of bytes in each range
+     * @return true The ranges are equal apart from letter case
+     * @return false The ranges differ
+     */
+    inline bool equals_ignore_case(const uint8_t * a, const uint8_t * b, size_t size) {
+        size_t i = 0;
+#if defined(EDJX_SIMD128)
+        const v128_t upper_a = wasm_i8x16_splat('A');
+        const v128_t upper_z = wasm_i8x16_splat('Z');
+        const v128_t case_bit = wasm_i8x16_splat(0x20);
+        for (; size - i >= BLOCK_SIZE; i += BLOCK_SIZE) {
+            v128_t x = wasm_v128_load(a + i);
+            v128_t y = wasm_v128_load(b + i);
+            x = wasm_v128_or(x, wasm_v128_and(case_bit,
+                wasm_v128_and(wasm_u8x16_ge(x, upper_a), wasm_u8x16_le(x, upper_z))));
+            y = wasm_v128_or(y, wasm_v128_and(case_bit,
+                wasm_v128_and(wasm_u8x16_ge(y, upper_a), wasm_u8x16_le(y, upper_z))));
+            if (!wasm_i8x16_all_true(wasm_i8x16_eq(x, y))) {
+                return false;
+            }
+        }
+#else
+        for (; size - i >= sizeof(uint64_t); i += sizeof(uint64_t)) {
+            uint64_t x = load_word(a + i);
+            uint64_t y = load_word(b + i);
+            if ((x | (upper_case_mask(x) >> 2)) != (y | (upper_case_mask(y) >> 2))) {
+                return false;
+            }
+        }
+#endif
+        for (; i < size; i++) {
+            uint8_t x = a[i] >= 'A' && a[i] <= 'Z' ? a[i] | 0x20 : a[i];
+            uint8_t y = b[i] >= 'A' && b[i] <= 'Z' ? b[i] | 0x20 : b[i];
+            if (x != y) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    namespace detail {
+
+        /// Returns true if `c` may appear in an HTTP token (RFC 9110, `tchar`).
+        constexpr bool is_token_char(uint8_t c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                || c == '!' || c == '#' || c == '$' || c == '%' || c == '&' || c == '\''
+                || c == '*' || c == '+' || c == '-' || c == '.' || c == '^' || c == '_'
+                || c == '`' || c == '|' || c == '~';
+        }
+
+        /// Returns true if `c` may appear in an HTTP field value.
+        constexpr bool is_field_value_char(uint8_t c) {
+            return c == '\t' || (c >= 0x20 && c != 0x7f);
+        }
+
+        /// Returns the length of the UTF-8 sequence at `p`, or 0 if it is invalid.
+        inline size_t utf8_sequence_length(const uint8_t * p, const uint8_t * end) {
+            uint8_t lead = p[0];
+            size_t length;
+            uint8_t min_second = 0x80;
+            uint8_t max_second = 0xbf;
+            if (lead < 0x80) {
+                return 1;
+            } else if (lead >= 0xc2 && lead <= 0xdf) {
+                length = 2;
+            } else if (lead >= 0xe0 && lead <= 0xef) {
+                length = 3;
+                if (lead == 0xe0) {
+                    min_second = 0xa0; // overlong
+                } else if (lead == 0xed) {
+                    max_second = 0x9f; // surrogates
+                }
+            } else if (lead >= 0xf0 && lead <= 0xf4) {
+                length = 4;
+                if (lead == 0xf0) {
+                    min_second = 0x90; // overlong
+                } else if (lead == 0xf4) {
+                    max_second = 0x8f; // above U+10FFFF
+                }
+            } else {
+                return 0;
+            }
+            if (static_cast<size_t>(end - p) < length || p[1] < min_second || p[1] > max_second) {
+                return 0;
+            }
+            for (size_t i = 2; i < length; i++) {
+                if ((p[i] & 0xc0) != 0x80) {
+                    return 0;
+                }
+            }
+            return length;
+        }
+
+    }
+
+    /**
+     * @brief Finds the first byte in `[begin, end)` that is not allowed
+     * in an HTTP token (e.g., a header name or a method).
+     *
+     * Blocks of letters, digits and `-` are skipped without looking at
+     * single bytes; other blocks are checked byte by byte.
+     *
+     * @param begin Start of the range
+     * @param end End of the range
+     * @return Pointer to the first invalid byte or `end` if there is none
+     */
+    inline const uint8_t * find_non_token(const uint8_t * begin, const uint8_t * end) {
+        const uint8_t * p = begin;
+#if defined(EDJX_SIMD128)
+        while (end - p >= static_cast<ptrdiff_t>(BLOCK_SIZE)) {
+            v128_t block = wasm_v128_load(p);
+            v128_t folded = wasm_v128_or(block, wasm_i8x16_splat(0x20));
+            v128_t common = wasm_v128_or(
+                wasm_v128_and(wasm_u8x16_ge(folded, wasm_i8x16_splat('a')), wasm_u8x16_le(folded, wasm_i8x16_splat('z'))),
+                wasm_v128_or(
+                    wasm_v128_and(wasm_u8x16_ge(block, wasm_i8x16_splat('0')), wasm_u8x16_le(block, wasm_i8x16_splat('9'))),
+                    wasm_i8x16_eq(block, wasm_i8x16_splat('-'))));
+            if (!wasm_i8x16_all_true(common)) {
+                for (size_t i = 0; i < BLOCK_SIZE; i++) {
+                    if (!detail::is_token_char(p[i])) {
+                        return p + i;
+                    }
+                }
+            }
+            p += BLOCK_SIZE;
+        }
+#else
+        while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+            uint64_t word = load_word(p);
+            uint64_t low7 = word & 0x7f7f7f7f7f7f7f7fULL;
+            // High bit set in each byte that is a letter, a digit or '-'.
+            uint64_t letter = upper_case_mask(word & ~broadcast(0x20));
+            uint64_t digit = (low7 + broadcast(0x80 - '0')) & ~(low7 + broadcast(0x80 - '9' - 1)) & ~word
+                & 0x8080808080808080ULL;
+            uint64_t x = word ^ broadcast('-');
+            uint64_t dash = ~(((x & 0x7f7f7f7f7f7f7f7fULL) + 0x7f7f7f7f7f7f7f7fULL) | x) & 0x8080808080808080ULL;
+            if ((letter | digit | dash) != 0x8080808080808080ULL) {
+                for (size_t i = 0; i < sizeof(uint64_t); i++) {
+                    if (!detail::is_token_char(p[i])) {
+                        return p + i;
+                    }
+                }
+            }
+            p += sizeof(uint64_t);
+        }
+#endif
+        for (; p < end; ++p) {
+            if (!detail::is_token_char(*p)) {
+                return p;
+            }
+        }
+        return end;
+    }
+
+    /**
+     * @brief Finds the first byte in `[begin, end)` that is not allowed
+     * in an HTTP field value: a control character other than HTAB, or DEL.
+     *
+     * @param begin Start of the range
+     * @param end End of the range
+     * @return Pointer to the first invalid byte or `end` if there is none
+     */
+    inline const uint8_t * find_invalid_field_value(const uint8_t * begin, const uint8_t * end) {
+        const uint8_t * p = begin;
+#if defined(EDJX_SIMD128)
+        while (end - p >= static_cast<ptrdiff_t>(BLOCK_SIZE)) {
+            v128_t block = wasm_v128_load(p);
+            v128_t invalid = wasm_v128_or(
+                wasm_v128_andnot(wasm_u8x16_lt(block, wasm_i8x16_splat(0x20)), wasm_i8x16_eq(block, wasm_i8x16_splat('\t'))),
+                wasm_i8x16_eq(block, wasm_i8x16_splat(0x7f)));
+            uint32_t mask = wasm_i8x16_bitmask(invalid);
+            if (mask != 0) {
+                return p + count_trailing_zeros(mask);
+            }
+            p += BLOCK_SIZE;
+        }
+#else
+        while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+            uint64_t word = load_word(p);
+            // Any byte below 0x20 (HTAB included) or equal to DEL; such
+            // words are checked byte by byte.
+            uint64_t candidates = ((word - broadcast(0x20)) & ~word & 0x8080808080808080ULL)
+                | zero_byte_mask(word ^ broadcast(0x7f));
+            if (candidates != 0) {
+                for (size_t i = 0; i < sizeof(uint64_t); i++) {
+                    if (!detail::is_field_value_char(p[i])) {
+                        return p + i;
+                    }
+                }
+            }
+            p += sizeof(uint64_t);
+        }
+#endif
+        for (; p < end; ++p) {
+            if (!detail::is_field_value_char(*p)) {
+                return p;
+            }
+        }
+        return end;
+    }
+
+    /**
+     * @brief Finds the first byte in `[begin, end)` that does not start
+     * a valid UTF-8 sequence (RFC 3629: no overlong forms, surrogates or
+     * code points above U+10FFFF).
+     *
+     * Blocks of ASCII are skipped without decoding.
+     *
+     * @param begin Start of the range
+     * @param end End of the range
+     * @return Pointer to the start of the first invalid sequence or `end`
+     * if the range is valid UTF-8
+     */
+    inline const uint8_t * find_invalid_utf8(const uint8_t * begin, const uint8_t * end) {
+        const uint8_t * p = begin;
+        while (p < end) {
+#if defined(EDJX_SIMD128)
+            if (end - p >= static_cast<ptrdiff_t>(BLOCK_SIZE) && wasm_i8x16_bitmask(wasm_v128_load(p)) == 0) {
+                p += BLOCK_SIZE;
+                continue;
+            }
+#else
+            if (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t))
+                    && (load_word(p) & 0x8080808080808080ULL) == 0) {
+                p += sizeof(uint64_t);
+                continue;
+            }
+#endif
+            size_t length = detail::utf8_sequence_length(p, end);
+            if (length == 0) {
+                return p;
+            }
+            p += length;
+        }
+        return end;
+    }
+
+}}
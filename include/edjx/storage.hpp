@@ -3,8 +3,10 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "expected.hpp"
 #include "stream.hpp"
 #include "error.hpp"
 
@@ -134,6 +136,248 @@ namespace storage {
             default_version(default_version) {}
     };
 
+    /**
+     * @brief File properties stored as a flat list of key-value pairs.
+     * 
+     * Most files carry only a handful of properties, so a flat vector
+     * with linear lookups is cheaper to build, copy and encode than
+     * a map with one node allocation per property.
+     * 
+     * Property keys and values must not contain `,` or `=` characters,
+     * and keys must not be empty; such properties are rejected, since
+     * they would be encoded as a different set of properties.
+     */
+    class FileProperties {
+    public:
+        /// A single property
+        typedef std::pair<std::string, std::string> Entry;
+
+        /**
+         * @brief Constructs an empty property list. Nothing is allocated
+         * until a property is set.
+         */
+        inline FileProperties() {}
+
+        /**
+         * @brief Constructs a property list from a property map
+         * (e.g., FileAttributes::properties). Invalid properties
+         * are skipped.
+         * 
+         * @param properties Property map
+         */
+        inline explicit FileProperties(const std::map<std::string, std::string> & properties) {
+            assign(properties);
+        }
+
+        /**
+         * @brief Check whether a property can be encoded.
+         * 
+         * @param key Property key
+         * @param value Property value
+         * @return true The key is not empty and neither the key nor the
+         * value contains `,` or `=`
+         * @return false The property is invalid
+         */
+        static inline bool is_valid(const std::string & key, const std::string & value) {
+            return !key.empty()
+                && key.find_first_of(",=") == std::string::npos
+                && value.find_first_of(",=") == std::string::npos;
+        }
+
+        /**
+         * @brief Replaces the contents with the properties from a map.
+         * Invalid properties are skipped.
+         * 
+         * @param properties Property map
+         * @return true All properties were valid
+         * @return false At least one property was skipped
+         */
+        inline bool assign(const std::map<std::string, std::string> & properties) {
+            entries.clear();
+            entries.reserve(properties.size());
+            bool all_valid = true;
+            for (const auto & property : properties) {
+                if (is_valid(property.first, property.second)) {
+                    entries.emplace_back(property.first, property.second);
+                } else {
+                    all_valid = false;
+                }
+            }
+            return all_valid;
+        }
+
+        /**
+         * @brief Sets a property, replacing any previous value.
+         * 
+         * @param key Property key
+         * @param value Property value
+         * @return true The property was set
+         * @return false The property is invalid (see is_valid()) and
+         * the list was not changed
+         */
+        inline bool set(const std::string & key, const std::string & value) {
+            if (!is_valid(key, value)) {
+                return false;
+            }
+            for (Entry & entry : entries) {
+                if (entry.first == key) {
+                    entry.second = value;
+                    return true;
+                }
+            }
+            entries.emplace_back(key, value);
+            return true;
+        }
+
+        /**
+         * @brief Returns the value of a property.
+         * 
+         * @param key Property key
+         * @return Pointer to the value, or nullptr if the property is not set
+         */
+        inline const std::string * get(const std::string & key) const {
+            for (const Entry & entry : entries) {
+                if (entry.first == key) {
+                    return &entry.second;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Removes a property.
+         * 
+         * @param key Property key
+         * @return true The property was removed
+         * @return false The property was not set
+         */
+        inline bool remove(const std::string & key) {
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->first == key) {
+                    entries.erase(it);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Removes all properties. The storage is kept for reuse.
+         */
+        inline void clear() {
+            entries.clear();
+        }
+
+        /**
+         * @brief Returns the number of properties.
+         * 
+         * @return Number of properties
+         */
+        inline size_t size() const {
+            return entries.size();
+        }
+
+        /**
+         * @brief Check whether there are no properties.
+         * 
+         * @return true No properties are set
+         * @return false At least one property is set
+         */
+        inline bool empty() const {
+            return entries.empty();
+        }
+
+        /**
+         * @brief Returns an iterator to the first property.
+         */
+        inline std::vector<Entry>::const_iterator begin() const {
+            return entries.begin();
+        }
+
+        /**
+         * @brief Returns an iterator past the last property.
+         */
+        inline std::vector<Entry>::const_iterator end() const {
+            return entries.end();
+        }
+
+        /**
+         * @brief Encodes the properties in the format expected by
+         * [`edjx::storage::put`] (`key1=value1,key2=value2`).
+         * 
+         * The encoded text is written into `result`, whose capacity is
+         * reused, so the same buffer can encode many property lists
+         * without reallocating.
+         * 
+         * @param result Encoded properties
+         */
+        inline void encode(std::string & result) const {
+            result.clear();
+            for (const Entry & entry : entries) {
+                if (!result.empty()) {
+                    result.push_back(',');
+                }
+                result.append(entry.first);
+                result.push_back('=');
+                result.append(entry.second);
+            }
+        }
+
+        /**
+         * @brief Replaces the contents with properties decoded from
+         * the `key1=value1,key2=value2` format.
+         * 
+         * Surrounding spaces of keys and values are trimmed.
+         * 
+         * @param text Encoded properties
+         * @return true The text was decoded successfully
+         * @return false A property is missing the `=` separator, has
+         * an empty key, or its value contains another `=`
+         */
+        inline bool decode(const std::string & text) {
+            entries.clear();
+            size_t pos = 0;
+            while (pos < text.size()) {
+                size_t comma = text.find(',', pos);
+                if (comma == std::string::npos) {
+                    comma = text.size();
+                }
+                size_t eq = text.find('=', pos);
+                if (eq == std::string::npos || eq > comma) {
+                    return false;
+                }
+                if (!set(trim(text, pos, eq), trim(text, eq + 1, comma))) {
+                    return false;
+                }
+                pos = comma + 1;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Converts the properties into a map (e.g., to fill
+         * FileAttributes::properties).
+         * 
+         * @return Property map
+         */
+        inline std::map<std::string, std::string> to_map() const {
+            return std::map<std::string, std::string>(entries.begin(), entries.end());
+        }
+
+    private:
+        static inline std::string trim(const std::string & text, size_t begin, size_t end) {
+            while (begin < end && text[begin] == ' ') {
+                begin++;
+            }
+            while (end > begin && text[end - 1] == ' ') {
+                end--;
+            }
+            return text.substr(begin, end - begin);
+        }
+
+        std::vector<Entry> entries;
+    };
+
     /**
      * @brief Returns a file from the EDJX Object Store.
      * 
@@ -195,6 +439,71 @@ namespace storage {
         const std::string & properties
     );
 
+    namespace detail {
+
+        /// Reusable memory for encoding FileProperties
+        inline std::string & properties_buffer() {
+            static std::string buffer;
+            return buffer;
+        }
+
+    }
+
+    /**
+     * @brief Uploads a file with typed properties to the EDJX Object Store.
+     * 
+     * The properties are encoded into a buffer that is reused by every
+     * call, so no memory is allocated for them on a warm instance.
+     * 
+     * @param result Result of the operation
+     * @param bucket_id Bucket ID
+     * @param file_name File name
+     * @param properties Properties
+     * @param contents File content
+     * @return edjx::error::StorageError::Success on success,
+     * some other value on failure
+     */
+    inline edjx::error::StorageError put(
+        StorageResponse & result,
+        const std::string & bucket_id,
+        const std::string & file_name,
+        const FileProperties & properties,
+        const std::vector<uint8_t> & contents
+    ) {
+        std::string & encoded = detail::properties_buffer();
+        properties.encode(encoded);
+        return put(result, bucket_id, file_name, encoded, contents);
+    }
+
+    /**
+     * @brief Starts streaming a file with typed properties to
+     * the EDJX Object Store.
+     * 
+     * The properties are encoded into a buffer that is reused by every
+     * call, like put() does.
+     * 
+     * @param response_streaming If successful, this method will populate
+     * this argument with a placeholder for the storage response.
+     * @param write_stream If successful, this method will populate this
+     * argument with a write stream to be used for streaming the data.
+     * @param bucket_id Bucket ID (where to put the file)
+     * @param file_name File name
+     * @param properties Properties of the file
+     * @return Returns edjx::error::StorageError::Success on success,
+     * some other value on failure
+     */
+    inline edjx::error::StorageError put_streaming(
+        StorageResponsePending & response_streaming,
+        edjx::stream::WriteStream & write_stream,
+        const std::string & bucket_id,
+        const std::string & file_name,
+        const FileProperties & properties
+    ) {
+        std::string & encoded = detail::properties_buffer();
+        properties.encode(encoded);
+        return put_streaming(response_streaming, write_stream, bucket_id, file_name, encoded);
+    }
+
     /**
      * @brief Deletes the given file from the EDJX Object Store.
      * 
@@ -245,4 +554,196 @@ namespace storage {
         const FileAttributes & attributes
     );
 
-}}
+    /**
+     * @brief Returns a file from the EDJX Object Store.
+     * 
+     * @param bucket_id Bucket ID
+     * @param file_name File name
+     * @return The file, or the error on failure
+     */
+    inline Expected<StorageResponse, edjx::error::StorageError> get(
+        const std::string & bucket_id,
+        const std::string & file_name
+    ) {
+        StorageResponse result;
+        edjx::error::StorageError err = get(result, bucket_id, file_name);
+        if (err != edjx::error::StorageError::Success) {
+            return err;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Uploads a file to the EDJX Object Store.
+     * 
+     * @param bucket_id Bucket ID
+     * @param file_name File name
+     * @param properties Properties
+     * @param contents File content
+     * @return Result of the operation, or the error on failure
+     */
+    inline Expected<StorageResponse, edjx::error::StorageError> put(
+        const std::string & bucket_id,
+        const std::string & file_name,
+        const std::string & properties,
+        const std::vector<uint8_t> & contents
+    ) {
+        StorageResponse result;
+        edjx::error::StorageError err = put(result, bucket_id, file_name, properties, contents);
+        if (err != edjx::error::StorageError::Success) {
+            return err;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Deletes the given file from the EDJX Object Store.
+     * 
+     * @param bucket_id Bucket ID
+     * @param file_name File Name
+     * @return edjx::error::StorageError::Success on success,
+     * some other value on failure
+     */
+    inline edjx::error::StorageError remove(
+        const std::string & bucket_id,
+        const std::string & file_name
+    ) {
+        return remove(StorageResponse(), bucket_id, file_name);
+    }
+
+    /**
+     * @brief Returns attributes associated with the given file from
+     * the EDJX Object Store.
+     * 
+     * @param bucket_id Bucket ID
+     * @param file_name File name
+     * @return Attributes of the file, or the error on failure
+     */
+    inline Expected<FileAttributes, edjx::error::StorageError> get_attributes(
+        const std::string & bucket_id,
+        const std::string & file_name
+    ) {
+        FileAttributes result;
+        edjx::error::StorageError err = get_attributes(result, bucket_id, file_name);
+        if (err != edjx::error::StorageError::Success) {
+            return err;
+        }
+        return result;
+    }
+
+
+    /**
+     * @brief Deletes several files from the same bucket.
+     * 
+     * Every file is attempted even if some deletions fail.
+     * 
+     * @param results Result of each deletion, in the order of `file_names`
+     * @param bucket_id Bucket ID
+     * @param file_names File names
+     * @return edjx::error::StorageError::Success if all files were deleted,
+     * otherwise the first error in `results`
+     */
+    inline edjx::error::StorageError remove_many(
+        std::vector<edjx::error::StorageError> & results,
+        const std::string & bucket_id,
+        const std::vector<std::string> & file_names
+    ) {
+        edjx::error::StorageError first_error = edjx::error::StorageError::Success;
+        results.clear();
+        results.reserve(file_names.size());
+        for (const std::string & file_name : file_names) {
+            edjx::error::StorageError err = remove(StorageResponse(), bucket_id, file_name);
+            results.push_back(err);
+            if (err != edjx::error::StorageError::Success
+                    && first_error == edjx::error::StorageError::Success) {
+                first_error = err;
+            }
+        }
+        return first_error;
+    }
+
+    namespace detail {
+
+        /// Maps a stream failure during a streamed upload to a StorageError.
+        inline edjx::error::StorageError from_stream_error(edjx::error::StreamError err) {
+            switch (err) {
+                case edjx::error::StreamError::Success:
+                    return edjx::error::StorageError::Success;
+                case edjx::error::StreamError::SystemError:
+                    return edjx::error::StorageError::SystemError;
+                case edjx::error::StreamError::StreamChunkTooLarge:
+                    return edjx::error::StorageError::ResourceLimit;
+                case edjx::error::StreamError::StreamChannelClosed:
+                case edjx::error::StreamError::StreamClosed:
+                    return edjx::error::StorageError::StorageChannelClosed;
+                default:
+                    return edjx::error::StorageError::InternalError;
+            }
+        }
+
+    }
+
+    /**
+     * @brief Copies a file within the EDJX Object Store.
+     * 
+     * The source is piped into the destination by the host, so the
+     * contents are not copied into the memory of the function.
+     * 
+     * @param result Result of the upload of the destination file
+     * @param src_bucket_id Bucket ID of the source file
+     * @param src_file_name Name of the source file
+     * @param dst_bucket_id Bucket ID of the destination file
+     * @param dst_file_name Name of the destination file
+     * @param copy_properties Whether the properties of the source file
+     * are copied (this takes an extra request)
+     * @return edjx::error::StorageError::Success on success,
+     * some other value on failure. If piping the contents fails, the
+     * upload is aborted so no truncated destination file is stored.
+     */
+    inline edjx::error::StorageError copy(
+        StorageResponse & result,
+        const std::string & src_bucket_id,
+        const std::string & src_file_name,
+        const std::string & dst_bucket_id,
+        const std::string & dst_file_name,
+        bool copy_properties = true
+    ) {
+        FileProperties properties;
+        if (copy_properties) {
+            FileAttributes attributes;
+            edjx::error::StorageError err = get_attributes(attributes, src_bucket_id, src_file_name);
+            if (err != edjx::error::StorageError::Success) {
+                return err;
+            }
+            if (attributes.properties_present && !properties.assign(attributes.properties)) {
+                return edjx::error::StorageError::InvalidAttributes;
+            }
+        }
+
+        StorageResponse source;
+        edjx::error::StorageError err = get(source, src_bucket_id, src_file_name);
+        if (err != edjx::error::StorageError::Success) {
+            return err;
+        }
+
+        StorageResponsePending pending;
+        edjx::stream::WriteStream write_stream;
+        err = put_streaming(pending, write_stream, dst_bucket_id, dst_file_name, properties);
+        if (err != edjx::error::StorageError::Success) {
+            edjx::stream::ReadStream(source.get_read_stream()).close();
+            return err;
+        }
+        edjx::stream::ReadStream read_stream = source.get_read_stream();
+        edjx::error::StreamError stream_err = read_stream.pipe_to(write_stream);
+        if (stream_err != edjx::error::StreamError::Success) {
+            write_stream.abort();
+            // Collect the response of the aborted upload so the host
+            // releases it; the stream error is what the caller needs.
+            StorageResponse aborted;
+            pending.get_storage_response(aborted);
+            return detail::from_stream_error(stream_err);
+        }
+        return pending.get_storage_response(result);
+    }
+
+}}
\ No newline at end of file
@@ -1,16 +1,65 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <initializer_list>
 #include <string>
 #include <vector>
 
 #include "error.hpp"
+#include "host.hpp"
 
 namespace edjx {
 
 /// Streaming API
 namespace stream {
 
+    /**
+     * @brief A read-only view of bytes to be written by
+     * WriteStream::write_chunks().
+     * 
+     * The buffer does not own the bytes; they must stay valid until
+     * the write returns.
+     */
+    struct ConstBuffer {
+        /// Pointer to the bytes
+        const uint8_t * data;
+        /// Number of bytes
+        size_t size;
+
+        inline ConstBuffer(const uint8_t * data, size_t size) : data(data), size(size) {}
+        inline ConstBuffer(const char * data, size_t size)
+            : data(reinterpret_cast<const uint8_t *>(data)), size(size) {}
+        inline ConstBuffer(const std::string & text)
+            : data(reinterpret_cast<const uint8_t *>(text.data())), size(text.size()) {}
+        inline ConstBuffer(const std::vector<uint8_t> & bytes) : data(bytes.data()), size(bytes.size()) {}
+    };
+
+    /**
+     * @brief A writable view of memory to be filled by
+     * ReadStream::read_chunks().
+     */
+    struct MutableBuffer {
+        /// Pointer to the memory
+        uint8_t * data;
+        /// Capacity in bytes
+        size_t size;
+
+        inline MutableBuffer(uint8_t * data, size_t size) : data(data), size(size) {}
+        inline MutableBuffer(std::vector<uint8_t> & bytes) : data(bytes.data()), size(bytes.size()) {}
+    };
+
+    namespace detail {
+
+        /// Reusable memory for gathering small buffers into one chunk;
+        /// it never holds more than WriteStream::GATHER_LIMIT bytes.
+        inline std::vector<uint8_t> & gather_buffer() {
+            static std::vector<uint8_t> buffer;
+            return buffer;
+        }
+
+    }
+
     /**
      * @brief This is a base class for the streams.
      */
@@ -93,6 +142,108 @@ namespace stream {
          * some other value on failure.
          */
         edjx::error::StreamError write_chunk(const std::vector<uint8_t> & bytes);
+        /**
+         * @brief Write a chunk of binary data into the write stream
+         * without copying it into a vector first.
+         * 
+         * @param data Pointer to the bytes
+         * @param size Number of bytes
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write_chunk(const uint8_t * data, size_t size) {
+            int32_t error_code = 0;
+            if (host_write_chunk(sd, data, static_cast<uint32_t>(size), &error_code) < 0) {
+                return edjx::host::to_stream_error(error_code);
+            }
+            return edjx::error::StreamError::Success;
+        }
+
+        /// Buffers of at least this size are written without being gathered
+        static const size_t GATHER_LIMIT = 64 * 1024;
+
+        /**
+         * @brief Write several buffers into the write stream.
+         * 
+         * Buffers smaller than GATHER_LIMIT are gathered and sent to the
+         * host in one call, so a response assembled from several pieces
+         * (e.g., a header fragment, a template and a payload) crosses into
+         * the host once instead of once per piece. A gathered chunk is
+         * sent before it would grow past GATHER_LIMIT, so no chunk of
+         * gathered data is larger than that. Larger buffers are passed
+         * to the host directly to avoid copying them.
+         * 
+         * @param buffers Buffers to write, in order
+         * @param count Number of buffers
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write_chunks(const ConstBuffer * buffers, size_t count) {
+            std::vector<uint8_t> & gathered = detail::gather_buffer();
+            gathered.clear();
+            for (size_t i = 0; i < count; i++) {
+                const ConstBuffer & buffer = buffers[i];
+                if (buffer.size < GATHER_LIMIT) {
+                    if (gathered.size() + buffer.size > GATHER_LIMIT) {
+                        edjx::error::StreamError err = write_chunk(gathered.data(), gathered.size());
+                        gathered.clear();
+                        if (err != edjx::error::StreamError::Success) {
+                            return err;
+                        }
+                    }
+                    if (gathered.capacity() < GATHER_LIMIT) {
+                        // Reserved once at the limit, so the buffer kept
+                        // for the instance never grows past it.
+                        gathered.reserve(GATHER_LIMIT);
+                    }
+                    gathered.insert(gathered.end(), buffer.data, buffer.data + buffer.size);
+                    continue;
+                }
+                if (!gathered.empty()) {
+                    edjx::error::StreamError err = write_chunk(gathered.data(), gathered.size());
+                    gathered.clear();
+                    if (err != edjx::error::StreamError::Success) {
+                        return err;
+                    }
+                }
+                edjx::error::StreamError err = write_chunk(buffer.data, buffer.size);
+                if (err != edjx::error::StreamError::Success) {
+                    return err;
+                }
+            }
+            if (gathered.empty()) {
+                return edjx::error::StreamError::Success;
+            }
+            edjx::error::StreamError err = write_chunk(gathered.data(), gathered.size());
+            gathered.clear();
+            return err;
+        }
+
+        /**
+         * @brief Write several buffers into the write stream.
+         * 
+         * ```
+         * write_stream.write_chunks({header, body, footer});
+         * ```
+         * 
+         * @param buffers Buffers to write, in order
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write_chunks(std::initializer_list<ConstBuffer> buffers) {
+            return write_chunks(buffers.begin(), buffers.size());
+        }
+
+        /**
+         * @brief Write several buffers into the write stream.
+         * 
+         * @param buffers Buffers to write, in order
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write_chunks(const std::vector<ConstBuffer> & buffers) {
+            return write_chunks(buffers.data(), buffers.size());
+        }
 
         /**
          * @brief Aborts sending data and closes the stream.
@@ -114,6 +265,118 @@ namespace stream {
         edjx::error::StreamError abort();
     };
 
+    /**
+     * @brief A write stream wrapper that coalesces small writes.
+     * 
+     * Every WriteStream::write_chunk() call crosses into the host and
+     * becomes a separate chunk on the wire. This class collects writes in
+     * a buffer and sends them as one chunk when the buffer is full or when
+     * flush() is called, so the caller decides where chunk boundaries are
+     * (e.g., after every server-sent event).
+     */
+    class BufferedWriteStream {
+    public:
+        /// Default buffer capacity in bytes
+        static const size_t DEFAULT_CAPACITY = 16 * 1024;
+
+        /**
+         * @brief Constructs a buffered writer on top of a write stream.
+         * 
+         * @param write_stream Underlying write stream
+         * @param capacity Buffered bytes that trigger an automatic flush
+         */
+        inline explicit BufferedWriteStream(
+            WriteStream & write_stream,
+            size_t capacity = DEFAULT_CAPACITY
+        ) : write_stream(write_stream),
+            capacity(capacity) {
+            buffer.reserve(capacity);
+        }
+
+        /**
+         * @brief Appends bytes to the buffer, flushing it when it is full.
+         * 
+         * @param data Pointer to the bytes
+         * @param size Number of bytes
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write(const uint8_t * data, size_t size) {
+            buffer.insert(buffer.end(), data, data + size);
+            if (buffer.size() >= capacity) {
+                return flush();
+            }
+            return edjx::error::StreamError::Success;
+        }
+
+        /**
+         * @brief Appends text to the buffer, flushing it when it is full.
+         * 
+         * @param text Text to write
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write(const std::string & text) {
+            return write(reinterpret_cast<const uint8_t *>(text.data()), text.size());
+        }
+
+        /**
+         * @brief Appends bytes to the buffer, flushing it when it is full.
+         * 
+         * @param bytes Bytes to write
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError write(const std::vector<uint8_t> & bytes) {
+            return write(bytes.data(), bytes.size());
+        }
+
+        /**
+         * @brief Sends the buffered bytes to the client as one chunk.
+         * 
+         * Does nothing if the buffer is empty.
+         * 
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError flush() {
+            if (buffer.empty()) {
+                return edjx::error::StreamError::Success;
+            }
+            edjx::error::StreamError err = write_stream.write_chunk(buffer);
+            buffer.clear();
+            return err;
+        }
+
+        /**
+         * @brief Flushes the buffer and closes the underlying stream.
+         * 
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError close() {
+            edjx::error::StreamError err = flush();
+            if (err != edjx::error::StreamError::Success) {
+                return err;
+            }
+            return write_stream.close();
+        }
+
+        /**
+         * @brief Returns the number of bytes waiting to be flushed.
+         * 
+         * @return Number of buffered bytes
+         */
+        inline size_t buffered() const {
+            return buffer.size();
+        }
+
+    private:
+        WriteStream & write_stream;
+        size_t capacity;
+        std::vector<uint8_t> buffer;
+    };
+
     /**
      * @brief Read stream class
      */
@@ -160,6 +423,520 @@ namespace stream {
          * some other value on failure.
          */
         edjx::error::StreamError read_all(std::vector<uint8_t> & result);
+
+        /**
+         * @brief Reads chunks from the stream and scatters them into
+         * buffers until all buffers are full or the stream ends.
+         * 
+         * Bytes of the last chunk that do not fit into the buffers are
+         * stored in `rest`, so no data is lost.
+         * 
+         * The host has no scatter read, so each chunk is read into
+         * a temporary vector (allocated once per call) and then copied
+         * into the buffers: every byte is copied twice. This saves the
+         * caller the splitting code, not copies; read_chunk() into
+         * a reused vector copies less.
+         * 
+         * @param buffers Buffers to fill, in order
+         * @param count Number of buffers
+         * @param bytes_read Number of bytes stored in the buffers
+         * @param rest Bytes read from the stream that did not fit
+         * @return Returns edjx::error::StreamError::Success if all buffers
+         * were filled, edjx::error::StreamError::EndOfStream if the stream
+         * ended first (`bytes_read` tells how much was read), some other
+         * value on failure.
+         */
+        inline edjx::error::StreamError read_chunks(
+            const MutableBuffer * buffers,
+            size_t count,
+            size_t & bytes_read,
+            std::vector<uint8_t> & rest
+        ) {
+            bytes_read = 0;
+            rest.clear();
+            size_t index = 0;
+            size_t offset = 0;
+            std::vector<uint8_t> chunk;
+            while (true) {
+                while (index < count && offset == buffers[index].size) {
+                    index++;
+                    offset = 0;
+                }
+                if (index == count) {
+                    return edjx::error::StreamError::Success;
+                }
+                edjx::error::StreamError err = read_chunk(chunk);
+                if (err != edjx::error::StreamError::Success) {
+                    return err;
+                }
+                size_t position = 0;
+                while (position < chunk.size() && index < count) {
+                    size_t n = buffers[index].size - offset;
+                    if (n > chunk.size() - position) {
+                        n = chunk.size() - position;
+                    }
+                    std::memcpy(buffers[index].data + offset, chunk.data() + position, n);
+                    position += n;
+                    offset += n;
+                    bytes_read += n;
+                    if (offset == buffers[index].size) {
+                        index++;
+                        offset = 0;
+                    }
+                }
+                if (position < chunk.size()) {
+                    rest.assign(chunk.begin() + position, chunk.end());
+                }
+            }
+        }
+
+        /**
+         * @brief Reads chunks from the stream and scatters them into
+         * buffers until all buffers are full or the stream ends.
+         * 
+         * @param buffers Buffers to fill, in order
+         * @param bytes_read Number of bytes stored in the buffers
+         * @param rest Bytes read from the stream that did not fit
+         * @return Returns edjx::error::StreamError::Success if all buffers
+         * were filled, edjx::error::StreamError::EndOfStream if the stream
+         * ended first, some other value on failure.
+         */
+        inline edjx::error::StreamError read_chunks(
+            std::initializer_list<MutableBuffer> buffers,
+            size_t & bytes_read,
+            std::vector<uint8_t> & rest
+        ) {
+            return read_chunks(buffers.begin(), buffers.size(), bytes_read, rest);
+        }
+    };
+
+    /**
+     * @brief A move-only owner of a stream that closes it when destroyed.
+     *
+     * ReadStream and WriteStream are copyable handles of a stream
+     * descriptor, so two copies can close the same stream. A UniqueStream
+     * is the single owner of its stream: it cannot be copied, and the
+     * stream is closed exactly once, either by close() or by the
+     * destructor. Use UniqueReadStream and UniqueWriteStream.
+     *
+     * Operations that end the stream on the host side (piping and
+     * aborting) must be called on the UniqueStream (pipe_to(), abort()),
+     * not on get(), so the owner does not close the stream again.
+     *
+     * @tparam S ReadStream or WriteStream
+     */
+    template <typename S>
+    class UniqueStream {
+    public:
+        /**
+         * @brief Constructs an owner of no stream.
+         */
+        inline UniqueStream() {}
+
+        /**
+         * @brief Takes ownership of a stream. The passed object must not
+         * be used to close the stream afterwards.
+         *
+         * @param stream Stream
+         */
+        inline explicit UniqueStream(const S & stream) : stream(stream) {}
+
+        inline UniqueStream(UniqueStream && other) : stream(other.release()) {}
+
+        inline UniqueStream & operator=(UniqueStream && other) {
+            if (this != &other) {
+                reset();
+                stream = other.release();
+            }
+            return *this;
+        }
+
+        UniqueStream(const UniqueStream &) = delete;
+        UniqueStream & operator=(const UniqueStream &) = delete;
+
+        inline ~UniqueStream() {
+            reset();
+        }
+
+        /**
+         * @brief Returns the owned stream.
+         *
+         * @return The stream
+         */
+        inline S & get() {
+            return stream;
+        }
+
+        inline S & operator*() {
+            return stream;
+        }
+
+        inline S * operator->() {
+            return &stream;
+        }
+
+        /**
+         * @brief Check whether a stream is owned and open.
+         *
+         * @return true A stream is owned
+         * @return false No stream is owned
+         */
+        inline bool is_open() const {
+            return stream.is_initialized();
+        }
+
+        /**
+         * @brief Closes the stream now.
+         *
+         * @return Returns edjx::error::StreamError::Success on success
+         * or if no stream is owned, some other value on failure.
+         */
+        inline edjx::error::StreamError close() {
+            if (!stream.is_initialized()) {
+                return edjx::error::StreamError::Success;
+            }
+            edjx::error::StreamError err = stream.close();
+            stream = S();
+            return err;
+        }
+
+        /**
+         * @brief Pipes the owned read stream into a write stream.
+         *
+         * The host closes both streams, so ownership of the read stream
+         * is given up, whether or not piping succeeds.
+         *
+         * @param write_stream Write stream to which the data is sent
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError pipe_to(WriteStream & write_stream) {
+            if (!stream.is_initialized()) {
+                return edjx::error::StreamError::StreamClosed;
+            }
+            return release().pipe_to(write_stream);
+        }
+
+        /**
+         * @brief Pipes the owned read stream into an owned write stream.
+         *
+         * The host closes both streams, so ownership of both is given up,
+         * whether or not piping succeeds.
+         *
+         * @param write_stream Write stream to which the data is sent
+         * @return Returns edjx::error::StreamError::Success on success,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError pipe_to(UniqueStream<WriteStream> & write_stream) {
+            if (!stream.is_initialized() || !write_stream.is_open()) {
+                return edjx::error::StreamError::StreamClosed;
+            }
+            WriteStream target = write_stream.release();
+            return release().pipe_to(target);
+        }
+
+        /**
+         * @brief Aborts the owned write stream and gives up ownership,
+         * since an aborted stream must not be closed.
+         *
+         * @return Returns edjx::error::StreamError::Success on success
+         * or if no stream is owned, some other value on failure.
+         */
+        inline edjx::error::StreamError abort() {
+            if (!stream.is_initialized()) {
+                return edjx::error::StreamError::Success;
+            }
+            return release().abort();
+        }
+
+        /**
+         * @brief Gives up ownership of the stream without closing it.
+         *
+         * @return The stream
+         */
+        inline S release() {
+            S released = stream;
+            stream = S();
+            return released;
+        }
+
+    private:
+        inline void reset() {
+            if (stream.is_initialized()) {
+                stream.close();
+            }
+            stream = S();
+        }
+
+        S stream;
+    };
+
+    /// Move-only read stream that is closed when destroyed
+    typedef UniqueStream<ReadStream> UniqueReadStream;
+    /// Move-only write stream that is closed when destroyed
+    typedef UniqueStream<WriteStream> UniqueWriteStream;
+
+    /**
+     * @brief A read stream wrapper with a read-ahead buffer.
+     * 
+     * Host reads are synchronous: the host fetches a chunk only when it is
+     * asked for one. Instead of one host call per parsing step, this class
+     * reads up to `read_ahead` chunks whenever its buffer runs low. Parsers
+     * can then look at the buffered bytes directly (peek(), find()) and
+     * consume them, without one host call per record.
+     */
+    class BufferedReadStream {
+    public:
+        /// Default number of chunks read by one refill
+        static const size_t DEFAULT_READ_AHEAD = 2;
+
+        /**
+         * @brief Constructs a buffered reader on top of a read stream.
+         * 
+         * @param read_stream Underlying read stream
+         * @param read_ahead Number of chunks read whenever the buffer
+         * needs more data (at least 1)
+         */
+        inline explicit BufferedReadStream(
+            ReadStream & read_stream,
+            size_t read_ahead = DEFAULT_READ_AHEAD
+        ) : read_stream(read_stream),
+            read_ahead(read_ahead > 0 ? read_ahead : 1),
+            start(0),
+            end_of_stream(false) {}
+
+        /**
+         * @brief Reads from the underlying stream until at least `size`
+         * bytes are buffered.
+         * 
+         * @param size Required number of buffered bytes
+         * @return Returns edjx::error::StreamError::Success if `size` bytes
+         * are buffered, edjx::error::StreamError::EndOfStream if the stream
+         * ended first, some other value on failure.
+         */
+        inline edjx::error::StreamError fill(size_t size) {
+            while (available() < size) {
+                if (end_of_stream) {
+                    return edjx::error::StreamError::EndOfStream;
+                }
+                edjx::error::StreamError err = refill();
+                if (err != edjx::error::StreamError::Success
+                        && err != edjx::error::StreamError::EndOfStream) {
+                    return err;
+                }
+            }
+            return edjx::error::StreamError::Success;
+        }
+
+        /**
+         * @brief Returns a pointer to the buffered bytes.
+         * 
+         * The pointer is invalidated by every call that reads from the
+         * underlying stream.
+         * 
+         * @return Pointer to the first unconsumed byte
+         */
+        inline const uint8_t * data() const {
+            return buffer.data() + start;
+        }
+
+        /**
+         * @brief Returns the number of buffered bytes.
+         * 
+         * @return Number of bytes available without reading from the stream
+         */
+        inline size_t available() const {
+            return buffer.size() - start;
+        }
+
+        /**
+         * @brief Discards buffered bytes that were processed by the caller.
+         * 
+         * @param size Number of bytes to discard (at most available())
+         */
+        inline void consume(size_t size) {
+            start += size < available() ? size : available();
+        }
+
+        /**
+         * @brief Check whether all data was read.
+         * 
+         * @return true The stream ended and the buffer is empty
+         * @return false More data may be available
+         */
+        inline bool at_end() const {
+            return end_of_stream && available() == 0;
+        }
+
+        /**
+         * @brief Returns the next bytes of the stream without consuming them.
+         * 
+         * @param size Number of bytes to look at
+         * @param result Pointer to the buffered bytes
+         * @param result_size Number of bytes at `result`; smaller than
+         * `size` only at the end of the stream
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream if fewer than `size`
+         * bytes are left, some other value on failure.
+         */
+        inline edjx::error::StreamError peek(size_t size, const uint8_t * & result, size_t & result_size) {
+            edjx::error::StreamError err = fill(size);
+            result = data();
+            result_size = available() < size ? available() : size;
+            return err;
+        }
+
+        /**
+         * @brief Finds a delimiter in the stream, reading more data
+         * as needed.
+         * 
+         * @param delimiter Delimiter bytes
+         * @param delimiter_size Number of delimiter bytes (at least 1)
+         * @param position Offset of the delimiter from data()
+         * @return Returns edjx::error::StreamError::Success if the delimiter
+         * was found, edjx::error::StreamError::EndOfStream if the stream
+         * ended first, some other value on failure.
+         */
+        inline edjx::error::StreamError find(
+            const uint8_t * delimiter,
+            size_t delimiter_size,
+            size_t & position
+        ) {
+            size_t from = 0;
+            while (true) {
+                const uint8_t * begin = data();
+                size_t size = available();
+                while (from + delimiter_size <= size) {
+                    const void * hit = std::memchr(begin + from, delimiter[0], size - from - delimiter_size + 1);
+                    if (hit == nullptr) {
+                        break;
+                    }
+                    size_t candidate = static_cast<const uint8_t *>(hit) - begin;
+                    if (std::memcmp(begin + candidate, delimiter, delimiter_size) == 0) {
+                        position = candidate;
+                        return edjx::error::StreamError::Success;
+                    }
+                    from = candidate + 1;
+                }
+                from = size >= delimiter_size ? size - delimiter_size + 1 : 0;
+                edjx::error::StreamError err = fill(size + 1);
+                if (err != edjx::error::StreamError::Success) {
+                    return err;
+                }
+            }
+        }
+
+        /**
+         * @brief Reads bytes up to and including a delimiter byte.
+         * 
+         * @param delimiter Delimiter byte
+         * @param result Bytes read, including the delimiter. At the end of
+         * the stream, the remaining bytes without a delimiter.
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream if the stream ended before
+         * a delimiter, some other value on failure.
+         */
+        inline edjx::error::StreamError read_until(uint8_t delimiter, std::vector<uint8_t> & result) {
+            return read_until(&delimiter, 1, result);
+        }
+
+        /**
+         * @brief Reads text up to and including a delimiter.
+         * 
+         * @param delimiter Delimiter (e.g., "\r\n")
+         * @param result Text read, including the delimiter. At the end of
+         * the stream, the remaining text without a delimiter.
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream if the stream ended before
+         * a delimiter, some other value on failure.
+         */
+        inline edjx::error::StreamError read_until(const std::string & delimiter, std::string & result) {
+            size_t position = 0;
+            edjx::error::StreamError err = find(
+                reinterpret_cast<const uint8_t *>(delimiter.data()), delimiter.size(), position);
+            size_t size = err == edjx::error::StreamError::Success ? position + delimiter.size() : available();
+            result.assign(reinterpret_cast<const char *>(data()), size);
+            consume(size);
+            return err;
+        }
+
+        /**
+         * @brief Reads up to `size` bytes.
+         * 
+         * @param result Destination
+         * @param size Number of bytes to read
+         * @param bytes_read Number of bytes stored in `result`
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream if fewer than `size`
+         * bytes were left, some other value on failure.
+         */
+        inline edjx::error::StreamError read(uint8_t * result, size_t size, size_t & bytes_read) {
+            edjx::error::StreamError err = fill(size);
+            bytes_read = available() < size ? available() : size;
+            std::memcpy(result, data(), bytes_read);
+            consume(bytes_read);
+            return err;
+        }
+
+        /**
+         * @brief Reads the buffered bytes, or the next chunk if the buffer
+         * is empty.
+         * 
+         * @param result Bytes read
+         * @return Returns edjx::error::StreamError::Success on success,
+         * edjx::error::StreamError::EndOfStream at the end of the stream,
+         * some other value on failure.
+         */
+        inline edjx::error::StreamError read_chunk(std::vector<uint8_t> & result) {
+            edjx::error::StreamError err = fill(1);
+            if (err != edjx::error::StreamError::Success) {
+                result.clear();
+                return err;
+            }
+            result.assign(data(), data() + available());
+            consume(available());
+            return edjx::error::StreamError::Success;
+        }
+
+    private:
+        inline edjx::error::StreamError read_until(
+            const uint8_t * delimiter,
+            size_t delimiter_size,
+            std::vector<uint8_t> & result
+        ) {
+            size_t position = 0;
+            edjx::error::StreamError err = find(delimiter, delimiter_size, position);
+            size_t size = err == edjx::error::StreamError::Success ? position + delimiter_size : available();
+            result.assign(data(), data() + size);
+            consume(size);
+            return err;
+        }
+
+        inline edjx::error::StreamError refill() {
+            if (start > 0 && start >= buffer.size() / 2) {
+                buffer.erase(buffer.begin(), buffer.begin() + start);
+                start = 0;
+            }
+            for (size_t i = 0; i < read_ahead; i++) {
+                edjx::error::StreamError err = read_stream.read_chunk(chunk);
+                if (err == edjx::error::StreamError::EndOfStream) {
+                    end_of_stream = true;
+                    return err;
+                }
+                if (err != edjx::error::StreamError::Success) {
+                    return err;
+                }
+                buffer.insert(buffer.end(), chunk.begin(), chunk.end());
+            }
+            return edjx::error::StreamError::Success;
+        }
+
+        ReadStream & read_stream;
+        size_t read_ahead;
+        std::vector<uint8_t> buffer;
+        std::vector<uint8_t> chunk;
+        size_t start;
+        bool end_of_stream;
     };
 
 }}
\ No newline at end of file